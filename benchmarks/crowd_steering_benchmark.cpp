@@ -0,0 +1,93 @@
+// Measures what crowd steering saves in a packed dungeon. Walkers wander
+// rows of halls joined by narrow doors, once moving as they want and once
+// steered around each other, from the same start. Reports the time per
+// tick and how many moves ran into another monster or a wall, the moves
+// that make monsters turn around and, for orcs, ask for a new path.
+//
+// Usage: crowd_steering_benchmark [width] [height] [monsters] [ticks]
+
+#include "model/crowd_steering.h"
+#include "support/walker_world.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Halls four rows high, separated by walls with a door every 12 columns
+std::unique_ptr<WalkerWorld> makeWorld(int width, int height,
+                                       int monsterCount) {
+  auto world = std::make_unique<WalkerWorld>(width, height);
+  for (int y = 4; y < height; y += 5) {
+    for (int x = 0; x < width; ++x) {
+      if (x % 12 != 6) {
+        world->map->grid.set(x, y, CellType::WALL);
+      }
+    }
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  uint32_t id = 0;
+  while (static_cast<int>(world->monsters.size()) < monsterCount) {
+    if (world->addWalker(Point(randomX(rng), randomY(rng)), id)) {
+      ++id;
+    }
+  }
+  return world;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : 1024;
+  const int height = argc > 2 ? std::atoi(argv[2]) : 1024;
+  const int monsterCount = argc > 3 ? std::atoi(argv[3]) : 200000;
+  const int ticks = argc > 4 ? std::atoi(argv[4]) : 50;
+  std::printf("map %dx%d, %d monsters, %d ticks\n", width, height,
+              monsterCount, ticks);
+  std::printf("%-8s %10s %12s %12s %10s\n", "steering", "ms/tick",
+              "moves/tick", "blocked/tick", "waits/tick");
+
+  for (bool steered : {false, true}) {
+    auto world = makeWorld(width, height, monsterCount);
+    CrowdSteering steering;
+    size_t moves = 0;
+    size_t blocked = 0;
+    size_t waits = 0;
+
+    auto start = Clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+      if (steered) {
+        steering.plan(*world->map, world->monsters);
+      }
+      for (size_t i = 0; i < world->monsters.size(); ++i) {
+        const auto &monster = world->monsters[i];
+        if (steered && steering.waits(i)) {
+          ++waits;
+          continue;
+        }
+        auto direction =
+            steered ? steering.stepOf(i) : monster->getVelocity();
+        if (world->tryMove(monster, monster->position + direction)) {
+          ++moves;
+        } else {
+          ++blocked;
+        }
+      }
+      world->map->journal.nextTick();
+    }
+    double msPerTick =
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count() /
+        ticks;
+    std::printf("%-8s %10.2f %12zu %12zu %10zu\n", steered ? "on" : "off",
+                msPerTick, moves / ticks, blocked / ticks, waits / ticks);
+  }
+  return 0;
+}
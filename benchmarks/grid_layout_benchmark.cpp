@@ -0,0 +1,134 @@
+// Compares A* and BFS throughput on the row-major, tiled and Morton grid
+// layouts. Every layout is filled from the same maze, so the searches visit
+// identical cells and only the memory access pattern differs.
+//
+// Usage: grid_layout_benchmark [width] [height] [queries]
+
+#include "algorithms/a_star.h"
+#include "algorithms/maze_generator.h"
+#include "utils/grid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+Grid buildGrid(const std::vector<std::string> &maze, GridLayout layout) {
+  Grid grid(maze[0].size(), maze.size(), layout);
+  for (size_t y = 0; y < maze.size(); ++y) {
+    for (size_t x = 0; x < maze[y].size(); ++x) {
+      grid.set(x, y, maze[y][x] == '#' ? CellType::WALL : CellType::EMPTY);
+    }
+  }
+  return grid;
+}
+
+// Floods the grid from start, keeping the visited flags in the grid's own
+// layout so both structures share the same locality
+size_t breadthFirstSearch(const Grid &grid, Point start) {
+  const int width = grid.getWidth();
+  const int height = grid.getHeight();
+  std::vector<uint8_t> visited(grid.capacity(), 0);
+  std::queue<Point> frontier;
+
+  frontier.push(start);
+  visited[grid.index(start.x, start.y)] = 1;
+  size_t reached = 0;
+
+  const Point offsets[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  while (!frontier.empty()) {
+    auto current = frontier.front();
+    frontier.pop();
+    ++reached;
+
+    for (const auto &offset : offsets) {
+      auto next = current + offset;
+      if (next.x < 0 || next.y < 0 || next.x >= width || next.y >= height) {
+        continue;
+      }
+      auto index = grid.index(next.x, next.y);
+      if (!visited[index] && grid.get(next.x, next.y) != CellType::WALL) {
+        visited[index] = 1;
+        frontier.push(next);
+      }
+    }
+  }
+  return reached;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+  const int height = argc > 2 ? std::atoi(argv[2]) : 4096;
+  const int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+
+  auto generationStart = Clock::now();
+  MazeGenerator generator(width, height,
+                          MazeGeneratorAlgorithm::DepthFirstSearch);
+  auto maze = generator.getMaze();
+  Point origin(generator.getStart().first, generator.getStart().second);
+  std::printf("maze %dx%d generated in %.0f ms\n", width, height,
+              millisecondsSince(generationStart));
+
+  // A* endpoints are free cells at most 64 steps apart on each axis, drawn
+  // once so every layout answers the same queries
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  std::uniform_int_distribution<int> randomOffset(-64, 64);
+  auto isFree = [&](const Point &p) {
+    return p.x >= 0 && p.y >= 0 && p.x < width && p.y < height &&
+           maze[p.y][p.x] != '#';
+  };
+  std::vector<std::pair<Point, Point>> endpoints;
+  while (static_cast<int>(endpoints.size()) < queries) {
+    Point from(randomX(rng), randomY(rng));
+    Point to = from + Point(randomOffset(rng), randomOffset(rng));
+    if (isFree(from) && isFree(to)) {
+      endpoints.emplace_back(from, to);
+    }
+  }
+
+  auto isNavigable = [](CellType cell) { return cell != CellType::WALL; };
+
+  std::printf("%-8s %12s %14s %12s %14s\n", "layout", "bfs ms",
+              "bfs Mcells/s", "a* ms", "a* us/query");
+  for (auto layout :
+       {GridLayout::ROW_MAJOR, GridLayout::TILED, GridLayout::MORTON}) {
+    auto grid = buildGrid(maze, layout);
+
+    auto bfsStart = Clock::now();
+    auto reached = breadthFirstSearch(grid, origin);
+    auto bfsMs = millisecondsSince(bfsStart);
+
+    auto aStarStart = Clock::now();
+    size_t pathCells = 0;
+    for (const auto &[from, to] : endpoints) {
+      AStar<CellType, Grid> aStar(grid, from, to, isNavigable);
+      pathCells += aStar.getPath().size();
+    }
+    auto aStarMs = millisecondsSince(aStarStart);
+
+    std::printf("%-8s %12.1f %14.1f %12.1f %14.1f\n",
+                gridLayoutName(layout).c_str(), bfsMs,
+                reached / bfsMs / 1000.0, aStarMs,
+                aStarMs * 1000.0 / endpoints.size());
+    // Keeps the searches observable, so they cannot be optimized away
+    if (reached == 0 || pathCells == 0) {
+      std::printf("  (no cells reached)\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Measures the memory and access cost of packed (4 bits per cell) grid
+// storage against one byte per cell. The default 16384x16384 map is filled
+// with random walls instead of a generated maze, so the benchmark measures
+// the grid alone and runs in a few seconds.
+//
+// Usage: grid_storage_benchmark [width] [height] [layout]
+
+#include "utils/grid.h"
+#include "utils/memory_tracker.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : 16384;
+  const int height = argc > 2 ? std::atoi(argv[2]) : 16384;
+  const auto layout = parseGridLayout(argc > 3 ? argv[3] : "row");
+  const size_t cells = static_cast<size_t>(width) * height;
+  const size_t randomAccesses = 1 << 24;
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  std::vector<std::pair<int, int>> positions(randomAccesses);
+  for (auto &position : positions) {
+    position = {randomX(rng), randomY(rng)};
+  }
+
+  std::printf("map %dx%d, %s layout\n", width, height,
+              gridLayoutName(layout).c_str());
+  std::printf("%-8s %10s %12s %12s %12s %12s\n", "storage", "MB",
+              "fill Mc/s", "scan Mc/s", "get Mc/s", "set Mc/s");
+
+  for (auto storage : {GridStorage::BYTE, GridStorage::PACKED}) {
+    Grid grid(width, height, layout, storage, CellType::WALL);
+    auto trackedBytes =
+        MemoryTracker::getInstance().getLiveBytes(MemoryTag::MAP_GRID);
+
+    // Carve roughly half of the cells, like a DFS maze
+    auto fillStart = Clock::now();
+    uint32_t bits = 0x9E3779B9u;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        bits ^= bits << 13;
+        bits ^= bits >> 17;
+        bits ^= bits << 5;
+        if (bits & 1) {
+          grid.set(x, y, CellType::EMPTY);
+        }
+      }
+    }
+    auto fillMs = millisecondsSince(fillStart);
+
+    auto scanStart = Clock::now();
+    size_t walls = 0;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        walls += grid.get(x, y) == CellType::WALL;
+      }
+    }
+    auto scanMs = millisecondsSince(scanStart);
+
+    auto getStart = Clock::now();
+    for (const auto &[x, y] : positions) {
+      walls += grid.get(x, y) == CellType::WALL;
+    }
+    auto getMs = millisecondsSince(getStart);
+
+    auto setStart = Clock::now();
+    for (const auto &[x, y] : positions) {
+      grid.set(x, y, CellType::TREASURE);
+    }
+    auto setMs = millisecondsSince(setStart);
+
+    std::printf("%-8s %10.1f %12.1f %12.1f %12.1f %12.1f\n",
+                gridStorageName(storage).c_str(), trackedBytes / 1048576.0,
+                cells / fillMs / 1000.0, cells / scanMs / 1000.0,
+                randomAccesses / getMs / 1000.0,
+                randomAccesses / setMs / 1000.0);
+    // Keeps the reads observable, so they cannot be optimized away
+    if (walls == 0) {
+      std::printf("  (no walls)\n");
+    }
+  }
+  return 0;
+}
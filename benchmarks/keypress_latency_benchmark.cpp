@@ -0,0 +1,611 @@
+// Measures how long a keypress takes to reach the screen. The game runs
+// under a pseudo-terminal in a scratch directory, on a map small enough to
+// fit the board, so the camera stays put and a move shows up as the player
+// glyph moving. The output goes through a small terminal emulator, and the
+// time from writing a key to the emulated screen showing the player on its
+// new cell is the latency. Bytes per frame come from the pty output and the
+// frame counter the game exports on exit.
+//
+// Usage: keypress_latency_benchmark [presses] [map width] [map height]
+//                                   [monsters per kind] [game binary]
+
+#include "utils/global_config.h"
+#include "utils/point.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <poll.h>
+#include <pty.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef GAME_BINARY
+#define GAME_BINARY "./main"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int screenRows = 50;
+const int screenColumns = 160;
+
+// The subset of xterm that ncurses uses to draw the game
+class Terminal {
+public:
+  Terminal(int rows, int columns)
+      : rows(rows), columns(columns), bottom(rows - 1),
+        cells(rows, std::string(columns, ' ')) {}
+
+  void feed(const char *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      feed(static_cast<unsigned char>(data[i]));
+    }
+  }
+
+  std::optional<Point> find(char glyph) const {
+    for (int row = 0; row < rows; ++row) {
+      auto column = cells[row].find(glyph);
+      if (column != std::string::npos) {
+        return Point(static_cast<int>(column), row);
+      }
+    }
+    return std::nullopt;
+  }
+
+  bool contains(const std::string &text) const {
+    for (const auto &line : cells) {
+      if (line.find(text) != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  char at(const Point &point) const {
+    if (point.y < 0 || point.y >= rows || point.x < 0 || point.x >= columns) {
+      return '\0';
+    }
+    return cells[point.y][point.x];
+  }
+
+private:
+  enum class State { TEXT, ESCAPE, CSI, CHARSET, OSC };
+
+  int rows;
+  int columns;
+  int row = 0;
+  int column = 0;
+  int top = 0;
+  int bottom;
+  int savedRow = 0;
+  int savedColumn = 0;
+  char lastChar = ' ';
+  State state = State::TEXT;
+  std::string parameters;
+  std::vector<std::string> cells;
+
+  void feed(unsigned char byte) {
+    switch (state) {
+    case State::TEXT:
+      text(byte);
+      break;
+    case State::ESCAPE:
+      escape(byte);
+      break;
+    case State::CSI:
+      if (byte >= 0x40 && byte <= 0x7E) {
+        state = State::TEXT;
+        control(byte);
+      } else {
+        parameters += static_cast<char>(byte);
+      }
+      break;
+    case State::CHARSET:
+      state = State::TEXT;
+      break;
+    case State::OSC:
+      if (byte == 0x07 || byte == 0x1B) {
+        state = State::TEXT;
+      }
+      break;
+    }
+  }
+
+  void text(unsigned char byte) {
+    switch (byte) {
+    case 0x1B:
+      state = State::ESCAPE;
+      return;
+    case '\r':
+      column = 0;
+      return;
+    case '\n':
+      lineFeed();
+      return;
+    case '\b':
+      column = std::max(0, column - 1);
+      return;
+    case '\t':
+      column = std::min(columns - 1, (column / 8 + 1) * 8);
+      return;
+    default:
+      break;
+    }
+    // Control characters and UTF-8 continuation bytes take no cell
+    if (byte < 0x20 || (byte >= 0x80 && byte < 0xC0)) {
+      return;
+    }
+    put(static_cast<char>(byte));
+  }
+
+  void put(char ch) {
+    if (column >= columns) {
+      column = 0;
+      lineFeed();
+    }
+    cells[row][column++] = ch;
+    lastChar = ch;
+  }
+
+  void escape(unsigned char byte) {
+    state = State::TEXT;
+    switch (byte) {
+    case '[':
+      parameters.clear();
+      state = State::CSI;
+      break;
+    case '(':
+    case ')':
+      state = State::CHARSET;
+      break;
+    case ']':
+      state = State::OSC;
+      break;
+    case '7':
+      savedRow = row;
+      savedColumn = column;
+      break;
+    case '8':
+      row = savedRow;
+      column = savedColumn;
+      break;
+    case 'D':
+      lineFeed();
+      break;
+    case 'E':
+      column = 0;
+      lineFeed();
+      break;
+    case 'M':
+      if (row == top) {
+        scrollDown(top, 1);
+      } else {
+        row = std::max(0, row - 1);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Numeric parameter at index, fallback when it is missing or zero
+  int parameter(size_t index, int fallback) const {
+    std::vector<int> values;
+    size_t start = parameters[0] == '?' || parameters[0] == '>' ? 1 : 0;
+    while (start <= parameters.size()) {
+      auto end = parameters.find(';', start);
+      if (end == std::string::npos) {
+        end = parameters.size();
+      }
+      values.push_back(
+          std::atoi(parameters.substr(start, end - start).c_str()));
+      start = end + 1;
+    }
+    return index < values.size() && values[index] > 0 ? values[index]
+                                                       : fallback;
+  }
+
+  void control(unsigned char command) {
+    if (!parameters.empty() && parameters[0] == '?') {
+      return; // private modes only change how the terminal behaves
+    }
+    int count = parameter(0, 1);
+    switch (command) {
+    case 'H':
+    case 'f':
+      row = std::min(rows - 1, parameter(0, 1) - 1);
+      column = std::min(columns - 1, parameter(1, 1) - 1);
+      break;
+    case 'A':
+      row = std::max(0, row - count);
+      break;
+    case 'B':
+      row = std::min(rows - 1, row + count);
+      break;
+    case 'C':
+      column = std::min(columns - 1, column + count);
+      break;
+    case 'D':
+      column = std::max(0, std::min(columns - 1, column) - count);
+      break;
+    case 'G':
+      column = std::min(columns - 1, count - 1);
+      break;
+    case 'd':
+      row = std::min(rows - 1, count - 1);
+      break;
+    case 'K':
+      eraseLine(parameter(0, 0));
+      break;
+    case 'J':
+      eraseDisplay(parameter(0, 0));
+      break;
+    case 'X':
+      for (int i = column; i < std::min(columns, column + count); ++i) {
+        cells[row][i] = ' ';
+      }
+      break;
+    case 'P':
+      cells[row].erase(std::min(column, columns - 1),
+                       std::min(count, columns - column));
+      cells[row].resize(columns, ' ');
+      break;
+    case '@':
+      cells[row].insert(std::min(column, columns - 1), count, ' ');
+      cells[row].resize(columns);
+      break;
+    case 'L':
+      if (row >= top && row <= bottom) {
+        scrollDown(row, count);
+      }
+      break;
+    case 'M':
+      if (row >= top && row <= bottom) {
+        scrollUp(row, count);
+      }
+      break;
+    case 'S':
+      scrollUp(top, count);
+      break;
+    case 'T':
+      scrollDown(top, count);
+      break;
+    case 'b':
+      for (int i = 0; i < count; ++i) {
+        put(lastChar);
+      }
+      break;
+    case 'r':
+      top = parameter(0, 1) - 1;
+      bottom = std::min(rows - 1, parameter(1, rows) - 1);
+      row = 0;
+      column = 0;
+      break;
+    default:
+      break; // colors and modes do not move anything
+    }
+  }
+
+  void lineFeed() {
+    if (row == bottom) {
+      scrollUp(top, 1);
+    } else if (row < rows - 1) {
+      ++row;
+    }
+  }
+
+  // Moves lines from..bottom up, blank lines enter at the bottom
+  void scrollUp(int from, int count) {
+    for (int i = 0; i < count; ++i) {
+      cells.erase(cells.begin() + from);
+      cells.insert(cells.begin() + bottom, std::string(columns, ' '));
+    }
+  }
+
+  // Moves lines from..bottom down, blank lines enter at from
+  void scrollDown(int from, int count) {
+    for (int i = 0; i < count; ++i) {
+      cells.erase(cells.begin() + bottom);
+      cells.insert(cells.begin() + from, std::string(columns, ' '));
+    }
+  }
+
+  void eraseLine(int mode) {
+    int from = mode == 0 ? std::min(column, columns) : 0;
+    int to = mode == 1 ? std::min(column + 1, columns) : columns;
+    std::fill(cells[row].begin() + from, cells[row].begin() + to, ' ');
+  }
+
+  void eraseDisplay(int mode) {
+    int first = mode == 0 ? row + 1 : 0;
+    int last = mode == 1 ? row - 1 : rows - 1;
+    for (int line = first; line <= last; ++line) {
+      cells[line].assign(columns, ' ');
+    }
+    if (mode == 0 || mode == 1) {
+      eraseLine(mode);
+    }
+  }
+};
+
+class Session {
+public:
+  Session(const std::string &binary) : terminal(screenRows, screenColumns) {
+    winsize size{};
+    size.ws_row = screenRows;
+    size.ws_col = screenColumns;
+    child = forkpty(&master, nullptr, nullptr, &size);
+    if (child == 0) {
+      setenv("TERM", "xterm", 1);
+      execl(binary.c_str(), binary.c_str(), static_cast<char *>(nullptr));
+      std::perror("execl");
+      _exit(127);
+    }
+  }
+
+  // A game still running, e.g. after a failed start, is killed
+  ~Session() {
+    if (child > 0) {
+      kill(child, SIGKILL);
+      waitpid(child, nullptr, 0);
+    }
+    if (master >= 0) {
+      close(master);
+    }
+  }
+
+  bool isRunning() const { return child > 0; }
+
+  void send(char key) {
+    if (write(master, &key, 1) != 1) {
+      std::perror("write");
+    }
+  }
+
+  // Reads output until done() holds or the timeout expires. Returns the
+  // time the output that satisfied done() arrived.
+  std::optional<Clock::time_point>
+  waitFor(const std::function<bool()> &done,
+          std::chrono::milliseconds timeout) {
+    auto deadline = Clock::now() + timeout;
+    while (!done()) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - Clock::now());
+      if (left.count() <= 0 || !read(static_cast<int>(left.count()))) {
+        return std::nullopt;
+      }
+    }
+    return lastRead;
+  }
+
+  // Reads until the game has been quiet for the given time, or for at most
+  // a second when it keeps drawing
+  void settle(std::chrono::milliseconds quiet) {
+    auto deadline = Clock::now() + std::chrono::seconds(1);
+    while (Clock::now() < deadline && read(static_cast<int>(quiet.count()))) {
+    }
+  }
+
+  int finish() {
+    send('q');
+    settle(std::chrono::milliseconds(200));
+    int status = 0;
+    waitpid(child, &status, 0);
+    child = -1;
+    close(master);
+    master = -1;
+    return status;
+  }
+
+  Terminal terminal;
+  size_t bytesRead = 0;
+
+private:
+  int master = -1;
+  pid_t child = -1;
+  Clock::time_point lastRead;
+
+  bool read(int timeoutMs) {
+    pollfd descriptor{master, POLLIN, 0};
+    if (poll(&descriptor, 1, timeoutMs) <= 0) {
+      return false;
+    }
+    char buffer[4096];
+    auto received = ::read(master, buffer, sizeof(buffer));
+    if (received <= 0) {
+      return false;
+    }
+    lastRead = Clock::now();
+    bytesRead += received;
+    terminal.feed(buffer, received);
+    return true;
+  }
+};
+
+// Working directory for the game, left and removed with all it holds
+// however the benchmark ends
+class ScratchDirectory {
+public:
+  ScratchDirectory() {
+    char pattern[] = "/tmp/md_latency_XXXXXX";
+    if (!mkdtemp(pattern)) {
+      return;
+    }
+    path = pattern;
+    entered = chdir(pattern) == 0;
+  }
+
+  ~ScratchDirectory() {
+    if (path.empty()) {
+      return;
+    }
+    if (entered && chdir("/") != 0) {
+      std::perror("leaving the scratch directory");
+    }
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+    if (error) {
+      std::fprintf(stderr, "could not remove %s: %s\n", path.c_str(),
+                   error.message().c_str());
+    }
+  }
+
+  bool isEntered() const { return entered; }
+
+private:
+  std::string path;
+  bool entered = false;
+};
+
+double percentile(std::vector<double> values, double percent) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  auto rank = static_cast<size_t>(percent / 100.0 * (values.size() - 1) + 0.5);
+  return values[rank];
+}
+
+long long exportedCounter(const std::string &path, const std::string &name) {
+  std::ifstream metrics(path);
+  std::string line;
+  while (std::getline(metrics, line)) {
+    if (line.compare(0, name.size() + 1, name + ' ') == 0) {
+      return std::atoll(line.c_str() + name.size() + 1);
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int presses = argc > 1 ? std::atoi(argv[1]) : 200;
+  const int width = argc > 2 ? std::atoi(argv[2]) : 100;
+  const int height = argc > 3 ? std::atoi(argv[3]) : 30;
+  const int monsters = argc > 4 ? std::atoi(argv[4]) : 0;
+  char binary[PATH_MAX];
+  if (!realpath(argc > 5 ? argv[5] : GAME_BINARY, binary)) {
+    std::perror("game binary");
+    return 1;
+  }
+
+  // The game reads config.txt from its working directory, start it in a
+  // scratch one with the defaults plus the benchmark's settings
+  ScratchDirectory directory;
+  if (!directory.isEntered()) {
+    std::perror("scratch directory");
+    return 1;
+  }
+  GlobalConfig::getInstance(); // writes the default config.txt
+  {
+    std::ofstream config("config.txt", std::ios::app);
+    config << "MapWidth=" << width << "\nMapHeight=" << height
+           << "\nGoblinsCount=" << monsters << "\nOrcsCount=" << monsters
+           << "\nTrollsCount=" << monsters << "\nDragonsCount=" << monsters
+           << "\nTreasureCount=0\nEventLogging=0\nMetricsExport=1"
+           << "\nMetricsExportPath=metrics.prom"
+           << "\nMetricsExportIntervalMs=600000\n";
+  }
+
+  std::printf("map %dx%d, %d monsters of each kind, %d presses, %dx%d "
+              "terminal\n",
+              width, height, monsters, presses, screenColumns, screenRows);
+
+  Session session(binary);
+  auto &screen = session.terminal;
+  auto started =
+      session.isRunning() &&
+      session.waitFor([&]() { return screen.contains("Start game"); },
+                      std::chrono::seconds(5));
+  if (started) {
+    session.send('1');
+    started = session.waitFor([&]() { return screen.find('@').has_value(); },
+                              std::chrono::seconds(5))
+                  .has_value();
+  }
+  if (!started) {
+    std::fprintf(stderr, "the game did not start, is the map too large for "
+                         "the terminal?\n");
+    return 1;
+  }
+  session.settle(std::chrono::milliseconds(300));
+
+  const std::pair<char, Point> moves[] = {{'d', Point(1, 0)},
+                                          {'s', Point(0, 1)},
+                                          {'a', Point(-1, 0)},
+                                          {'w', Point(0, -1)}};
+  std::vector<double> latencies;
+  size_t responseBytes = 0;
+  int missed = 0;
+  int heading = 0;
+  auto bytesBefore = session.bytesRead;
+
+  for (int press = 0; press < presses; ++press) {
+    auto player = screen.find('@');
+    if (!player) {
+      break;
+    }
+
+    // Keep walking the same way until blocked, then turn
+    int turns = 0;
+    while (turns < 4 && screen.at(*player + moves[heading].second) != ' ') {
+      heading = (heading + 1) % 4;
+      ++turns;
+    }
+    if (turns == 4) {
+      std::fprintf(stderr, "the player is walled in\n");
+      break;
+    }
+    auto target = *player + moves[heading].second;
+
+    auto bytes = session.bytesRead;
+    auto pressed = Clock::now();
+    session.send(moves[heading].first);
+    auto shown = session.waitFor(
+        [&]() { return screen.find('@') == std::optional<Point>(target); },
+        std::chrono::seconds(1));
+    if (!shown) {
+      ++missed; // e.g. a monster stepped into the cell first
+    } else {
+      latencies.push_back(
+          std::chrono::duration<double, std::milli>(*shown - pressed).count());
+      responseBytes += session.bytesRead - bytes;
+    }
+    // Let the frame finish before the next key, keys typed faster than the
+    // game draws are dropped by flushinp()
+    session.settle(std::chrono::milliseconds(60));
+  }
+
+  auto bytesDuring = session.bytesRead - bytesBefore;
+  session.finish();
+  auto frames = exportedCounter("metrics.prom", "md_frames_drawn_total");
+
+  std::printf("%-10s %10s %10s %10s %10s %10s\n", "presses", "p50 ms",
+              "p90 ms", "p99 ms", "max ms", "missed");
+  std::printf("%-10zu %10.2f %10.2f %10.2f %10.2f %10d\n", latencies.size(),
+              percentile(latencies, 50), percentile(latencies, 90),
+              percentile(latencies, 99), percentile(latencies, 100), missed);
+  std::printf("bytes per keypress response: %.0f\n",
+              latencies.empty()
+                  ? 0.0
+                  : static_cast<double>(responseBytes) / latencies.size());
+  if (frames > 0) {
+    std::printf("bytes per frame: %.0f (%zu bytes during the run, %lld "
+                "frames in the whole session)\n",
+                static_cast<double>(session.bytesRead) / frames, bytesDuring,
+                frames);
+  }
+  return 0;
+}
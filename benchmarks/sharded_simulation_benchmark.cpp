@@ -0,0 +1,107 @@
+// Measures how a sharded monster tick scales with worker threads. Random
+// walkers roam a large open map with scattered walls, and every thread
+// count replays the same ticks from the same start, so the final state is
+// also compared to confirm the results do not depend on the thread count.
+//
+// Usage: sharded_simulation_benchmark [width] [height] [monsters] [ticks]
+//                                     [strip width] [max threads]
+
+#include "model/sharded_simulation.h"
+#include "support/walker_world.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::unique_ptr<WalkerWorld> makeWorld(int width, int height,
+                                       int monsterCount) {
+  auto world = std::make_unique<WalkerWorld>(width, height);
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  for (int i = 0; i < width * height / 10; ++i) {
+    world->map->grid.set(randomX(rng), randomY(rng), CellType::WALL);
+  }
+
+  uint32_t id = 0;
+  while (static_cast<int>(world->monsters.size()) < monsterCount) {
+    if (world->addWalker(Point(randomX(rng), randomY(rng)), id)) {
+      ++id;
+    }
+  }
+  return world;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+  const int height = argc > 2 ? std::atoi(argv[2]) : 1024;
+  const int monsterCount = argc > 3 ? std::atoi(argv[3]) : 200000;
+  const int ticks = argc > 4 ? std::atoi(argv[4]) : 50;
+  const int stripWidth = argc > 5 ? std::atoi(argv[5]) : 64;
+
+  const unsigned int maxThreads =
+      argc > 6 ? std::atoi(argv[6])
+               : std::max(1u, std::thread::hardware_concurrency());
+  std::printf("map %dx%d, %d monsters, %d ticks, strips of %d columns, "
+              "up to %u threads\n",
+              width, height, monsterCount, ticks, stripWidth, maxThreads);
+  std::printf("%-8s %12s %10s %10s\n", "threads", "ms/tick", "speedup",
+              "same");
+
+  double baseline = 0;
+  std::vector<Point> reference;
+  for (unsigned int threads = 1; threads <= maxThreads;
+       threads = threads < maxThreads ? std::min(threads * 2, maxThreads)
+                                      : threads + 1) {
+    auto world = makeWorld(width, height, monsterCount);
+    ShardedSimulation simulation(stripWidth, threads);
+
+    auto localStep = [&world](size_t index,
+                              const ShardedSimulation::Strip &strip)
+        -> std::optional<Point> {
+      const auto &monster = world->monsters[index];
+      auto target = monster->position + monster->getVelocity();
+      if (!strip.contains(target)) {
+        return target;
+      }
+      world->tryMove(monster, target);
+      return std::nullopt;
+    };
+    auto borderStep = [&world](const std::shared_ptr<Monster> &monster,
+                               const Point &target) {
+      world->tryMove(monster, target);
+    };
+
+    auto start = Clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+      simulation.tick(*world->map, world->monsters, localStep, borderStep);
+      world->map->journal.nextTick();
+    }
+    double msPerTick =
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count() /
+        ticks;
+
+    std::vector<Point> positions;
+    for (const auto &monster : world->monsters) {
+      positions.push_back(monster->position);
+    }
+    if (reference.empty()) {
+      reference = positions;
+      baseline = msPerTick;
+    }
+    std::printf("%-8u %12.2f %10.2f %10s\n", threads, msPerTick,
+                baseline / msPerTick, positions == reference ? "yes" : "NO");
+  }
+  return 0;
+}
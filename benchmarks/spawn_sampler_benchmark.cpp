@@ -0,0 +1,95 @@
+// Compares spreading spawns with the Poisson disk sampler to dropping them
+// on random free cells, on a large open map with scattered walls. Reports
+// the time taken and how crowded the spawns are: the share of spawns with
+// another one closer than the spacing.
+//
+// Usage: spawn_sampler_benchmark [width] [height] [spawns] [spacing]
+
+#include "algorithms/poisson_disk_sampler.h"
+#include "model/map.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Map makeMap(int width, int height) {
+  Map map(width, height);
+  map.grid = Grid(width, height);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  for (int i = 0; i < width * height / 5; ++i) {
+    map.grid.set(randomX(rng), randomY(rng), CellType::WALL);
+  }
+  return map;
+}
+
+// Share of points with a neighbour closer than spacing, looked up on a
+// bucket grid as wide as the spacing
+double crowded(const std::vector<Point> &points, int width, int height,
+               int spacing) {
+  int columns = width / spacing + 1;
+  int rows = height / spacing + 1;
+  std::vector<std::vector<Point>> buckets(columns * rows);
+  for (const auto &point : points) {
+    buckets[point.y / spacing * columns + point.x / spacing].push_back(point);
+  }
+  size_t count = 0;
+  for (const auto &point : points) {
+    bool close = false;
+    for (int y = point.y / spacing - 1; y <= point.y / spacing + 1; ++y) {
+      for (int x = point.x / spacing - 1; x <= point.x / spacing + 1; ++x) {
+        if (x < 0 || y < 0 || x >= columns || y >= rows) {
+          continue;
+        }
+        for (const auto &other : buckets[y * columns + x]) {
+          close |= !(other == point) && point.distance(other) < spacing;
+        }
+      }
+    }
+    count += close;
+  }
+  return points.empty() ? 0 : 100.0 * count / points.size();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+  const int height = argc > 2 ? std::atoi(argv[2]) : 1024;
+  const size_t spawns = argc > 3 ? std::atoi(argv[3]) : 100000;
+  const int spacing = argc > 4 ? std::atoi(argv[4]) : 4;
+  std::printf("map %dx%d, %zu spawns, spacing %d\n", width, height, spawns,
+              spacing);
+  std::printf("%-10s %10s %10s %10s\n", "placement", "ms", "spawns",
+              "crowded %");
+
+  auto randomMap = makeMap(width, height);
+  auto start = Clock::now();
+  std::vector<Point> random;
+  for (size_t i = 0; i < spawns; ++i) {
+    random.push_back(randomMap.randomFreePosition());
+    randomMap.setCellType(random.back(), CellType::GOBLIN);
+  }
+  double randomMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::printf("%-10s %10.1f %10zu %10.1f\n", "random", randomMs,
+              random.size(), crowded(random, width, height, spacing));
+
+  auto map = makeMap(width, height);
+  start = Clock::now();
+  PoissonDiskSampler sampler(
+      width, height,
+      [&map](const Point &point) { return map.isPositionFree(point); }, 42);
+  auto spread = sampler.sample(spawns, spacing);
+  double spreadMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::printf("%-10s %10.1f %10zu %10.1f\n", "poisson", spreadMs,
+              spread.size(), crowded(spread, width, height, spacing));
+  return 0;
+}
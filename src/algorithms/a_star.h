@@ -1,16 +1,20 @@
 #ifndef A_STAR_H
 #define A_STAR_H
 
+#include "utils/memory_tracker.h"
+#include "utils/metrics.h"
 #include "utils/point.h"
 #include <cmath>
 #include <deque>
+#include <functional>
 #include <limits>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-template <typename T> class AStar {
+template <typename T, typename Grid = std::vector<std::vector<T>>>
+class AStar {
 public:
   struct Node {
     Point point;
@@ -25,11 +29,30 @@ public:
   };
 
 private:
+  template <typename U>
+  using ScratchAllocator = TrackingAllocator<U, MemoryTag::PATHFINDING>;
+  using NodeMap =
+      std::unordered_map<Point, Node, std::hash<Point>, std::equal_to<Point>,
+                         ScratchAllocator<std::pair<const Point, Node>>>;
+  using VisitedSet = std::unordered_set<Point, std::hash<Point>,
+                                        std::equal_to<Point>,
+                                        ScratchAllocator<Point>>;
+
   std::deque<Point> bestPath;
   std::function<bool(T)> isNavigable;
 
-  std::vector<Point> getNeighbors(const Point &p,
-                                  const std::vector<std::vector<T>> &grid) {
+  // Search state, kept between calls to step()
+  const Grid *grid = nullptr;
+  Point start;
+  Point end;
+  NodeMap nodes;
+  VisitedSet visited;
+  std::priority_queue<Point, std::vector<Point, ScratchAllocator<Point>>,
+                      std::function<bool(Point, Point)>>
+      queue;
+  uint64_t expanded = 0;
+
+  std::vector<Point> getNeighbors(const Point &p, const Grid &grid) {
     std::vector<Point> neighbors;
     const auto px = p.x;
     const auto py = p.y;
@@ -54,27 +77,65 @@ private:
   }
 
 public:
+  enum class Status { IDLE, SEARCHING, FOUND, NOT_FOUND };
+
+  // Resumable search, started with begin() and advanced with step()
+  explicit AStar(std::function<bool(T)> isNavigableFunc =
+                     [](T value) { return static_cast<bool>(value); })
+      : isNavigable(std::move(isNavigableFunc)),
+        queue([this](Point a, Point b) {
+          return nodes[a].totalEstimatedCost > nodes[b].totalEstimatedCost;
+        }) {}
+
   AStar(
-      const std::vector<std::vector<T>> &grid, Point start, Point end,
+      const Grid &grid, Point start, Point end,
       std::function<bool(T)> isNavigableFunc =
           [](T value) { return static_cast<bool>(value); })
-      : isNavigable(std::move(isNavigableFunc)) {
+      : AStar(std::move(isNavigableFunc)) {
     solve(grid, std::move(start), std::move(end));
   }
 
-  void solve(const std::vector<std::vector<T>> &grid, Point start, Point end) {
-    std::unordered_map<Point, Node> nodes;
-    std::unordered_set<Point> visited;
-    std::priority_queue<Point, std::vector<Point>,
-                        std::function<bool(Point, Point)>>
-        queue([&nodes](Point a, Point b) {
-          return nodes[a].totalEstimatedCost > nodes[b].totalEstimatedCost;
-        });
+  // The queue comparator refers to this object
+  AStar(const AStar &) = delete;
+  AStar &operator=(const AStar &) = delete;
+
+  void solve(const Grid &grid, Point start, Point end) {
+    begin(grid, std::move(start), std::move(end));
+    step(std::numeric_limits<size_t>::max());
+  }
+
+  // Resets the search, the grid has to outlive it
+  void begin(const Grid &searchGrid, Point from, Point to) {
+    static auto &calls = MetricsRegistry::getInstance().counter(
+        "md_astar_calls_total", "Number of A* searches");
+    calls.increment();
+
+    grid = &searchGrid;
+    start = std::move(from);
+    end = std::move(to);
+    bestPath.clear();
+    nodes.clear();
+    visited.clear();
+    while (!queue.empty()) {
+      queue.pop();
+    }
+    expanded = 0;
+    status = Status::SEARCHING;
 
     nodes[start] = Node(start, {}, 0, heuristic(start, end));
     queue.push(start);
+  }
 
-    while (!queue.empty()) {
+  // Expands at most maxExpansions nodes and reports where the search stands
+  Status step(size_t maxExpansions) {
+    static auto &expansions = MetricsRegistry::getInstance().counter(
+        "md_astar_node_expansions_total", "Nodes expanded by A* searches");
+    if (status != Status::SEARCHING) {
+      return status;
+    }
+
+    size_t expandedNow = 0;
+    while (!queue.empty() && expandedNow < maxExpansions) {
       Point current = queue.top();
       queue.pop();
 
@@ -83,6 +144,7 @@ public:
         continue;
 
       visited.insert(current);
+      ++expandedNow;
 
       if (current == end) {
         while (current != start) {
@@ -91,10 +153,11 @@ public:
         }
 
         bestPath.push_front(start);
-        return;
+        status = Status::FOUND;
+        break;
       }
 
-      for (const auto &neighbor : getNeighbors(current, grid)) {
+      for (const auto &neighbor : getNeighbors(current, *grid)) {
         if (visited.count(neighbor))
           continue; // Ignore if neighbor was already visited
 
@@ -110,9 +173,22 @@ public:
         }
       }
     }
+
+    if (status == Status::SEARCHING && queue.empty()) {
+      status = Status::NOT_FOUND;
+    }
+    expanded += expandedNow;
+    expansions.increment(expandedNow);
+    return status;
   }
 
+  Status getStatus() const { return status; }
+  uint64_t getExpansions() const { return expanded; }
+
   [[nodiscard]] auto getPath() const -> std::deque<Point> { return bestPath; }
+
+private:
+  Status status = Status::IDLE;
 };
 
 #endif // A_STAR_H
@@ -0,0 +1,99 @@
+#include "bsp_rooms_generator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+BspRoomsGenerator::BspRoomsGenerator(unsigned int width, unsigned int height,
+                                     unsigned int seed)
+    : maze(height, std::string(width, '#')), random_engine(seed) {
+  // Parts keep a wall on their right and bottom edges, the outer wall
+  // closes the left and top
+  if (width >= 5 && height >= 5) {
+    split(1, 1, width - 1, height - 1);
+  }
+  if (rooms.empty() && width >= 3 && height >= 3) {
+    maze[1][1] = ' ';
+  }
+}
+
+std::pair<unsigned int, unsigned int> BspRoomsGenerator::getStart() const {
+  if (rooms.empty()) {
+    return std::make_pair(1, 1);
+  }
+  auto centre = rooms.front().centre();
+  return std::make_pair(centre.x, centre.y);
+}
+
+std::pair<unsigned int, unsigned int> BspRoomsGenerator::getEnd() const {
+  if (rooms.empty()) {
+    return std::make_pair(1, 1);
+  }
+  auto centre = rooms.back().centre();
+  return std::make_pair(centre.x, centre.y);
+}
+
+int BspRoomsGenerator::random(int low, int high) {
+  return std::uniform_int_distribution<int>(low, high)(random_engine);
+}
+
+void BspRoomsGenerator::split(int x, int y, int width, int height) {
+  bool acrossWidth = width >= 2 * minPartSize;
+  bool acrossHeight = height >= 2 * minPartSize;
+  if (acrossWidth && acrossHeight) {
+    acrossWidth = width != height ? width > height : random(0, 1) == 1;
+    acrossHeight = !acrossWidth;
+  }
+
+  if (!acrossWidth && !acrossHeight) {
+    // A room inside the part, leaving its right and bottom edges as walls
+    Room room{};
+    room.width = random(std::min(3, width - 1), width - 1);
+    room.height = random(std::min(3, height - 1), height - 1);
+    room.x = x + random(0, width - 1 - room.width);
+    room.y = y + random(0, height - 1 - room.height);
+    for (int row = room.y; row < room.y + room.height; ++row) {
+      std::fill_n(maze[row].begin() + room.x, room.width, ' ');
+    }
+    rooms.push_back(room);
+    return;
+  }
+
+  auto firstRoom = rooms.size();
+  size_t secondRoom;
+  if (acrossWidth) {
+    auto cut = random(minPartSize, width - minPartSize);
+    split(x, y, cut, height);
+    secondRoom = rooms.size();
+    split(x + cut, y, width - cut, height);
+  } else {
+    auto cut = random(minPartSize, height - minPartSize);
+    split(x, y, width, cut);
+    secondRoom = rooms.size();
+    split(x, y + cut, width, height - cut);
+  }
+
+  // Join the two halves where their rooms are closest
+  auto closest = std::make_pair(firstRoom, secondRoom);
+  auto closestDistance = std::numeric_limits<int>::max();
+  for (auto first = firstRoom; first < secondRoom; ++first) {
+    for (auto second = secondRoom; second < rooms.size(); ++second) {
+      auto offset = rooms[first].centre() - rooms[second].centre();
+      auto distance = std::abs(offset.x) + std::abs(offset.y);
+      if (distance < closestDistance) {
+        closestDistance = distance;
+        closest = std::make_pair(first, second);
+      }
+    }
+  }
+  carveCorridor(rooms[closest.first].centre(), rooms[closest.second].centre());
+}
+
+void BspRoomsGenerator::carveCorridor(const Point &from, const Point &to) {
+  // Along the row of from, then along the column of to
+  for (int x = std::min(from.x, to.x); x <= std::max(from.x, to.x); ++x) {
+    maze[from.y][x] = ' ';
+  }
+  for (int y = std::min(from.y, to.y); y <= std::max(from.y, to.y); ++y) {
+    maze[y][to.x] = ' ';
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef BSP_ROOMS_GENERATOR_H
+#define BSP_ROOMS_GENERATOR_H
+
+#include "room_graph.h"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BspRoomsGenerator {
+  /**
+   * @brief Generates rooms joined by corridors with binary space partitioning.
+   * The map is split in two across its longer side, and so are the parts,
+   * until they are too small to split, and each part gets a room of random
+   * size. Going back up the splits, the closest rooms on the two sides of
+   * every split are joined by an L-shaped corridor, so every room can be
+   * reached. Unlike the mazes, corridors crossing rooms or each other make
+   * loops.
+   * The rooms are kept for building the level's RoomGraph.
+   */
+public:
+  static constexpr int minPartSize = 8;
+
+  BspRoomsGenerator(unsigned int width, unsigned int height,
+                    unsigned int seed);
+
+  // '#' for walls and ' ' for floors, like MazeGenerator::getMaze
+  const std::vector<std::string> &getMaze() const { return maze; }
+  const std::vector<Room> &getRooms() const { return rooms; }
+  // Centres of the first and of the last room
+  std::pair<unsigned int, unsigned int> getStart() const;
+  std::pair<unsigned int, unsigned int> getEnd() const;
+
+private:
+  std::vector<std::string> maze;
+  std::vector<Room> rooms;
+  std::default_random_engine random_engine;
+
+  int random(int low, int high); // inclusive
+  void split(int x, int y, int width, int height);
+  void carveCorridor(const Point &from, const Point &to);
+};
+
+#endif // BSP_ROOMS_GENERATOR_H
@@ -0,0 +1,109 @@
+#include "connected_components.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+uint32_t findRoot(std::vector<uint32_t> &parent, uint32_t cell) {
+  while (parent[cell] != cell) {
+    parent[cell] = parent[parent[cell]];
+    cell = parent[cell];
+  }
+  return cell;
+}
+
+void unite(std::vector<uint32_t> &parent, uint32_t first, uint32_t second) {
+  first = findRoot(parent, first);
+  second = findRoot(parent, second);
+  // The smaller index becomes the root, so every set is rooted at its
+  // first cell whichever order the cells were joined in
+  if (first < second) {
+    parent[second] = first;
+  } else if (second < first) {
+    parent[first] = second;
+  }
+}
+} // namespace
+
+ConnectedComponents::ConnectedComponents(const Grid &grid, WorkerPool *pool)
+    : width(grid.getWidth()), height(grid.getHeight()),
+      labels(static_cast<size_t>(width) * height, none) {
+  auto isOpen = [&grid](unsigned int x, unsigned int y) {
+    return grid.get(x, y) != CellType::WALL;
+  };
+  auto stripCount = (height + stripRows - 1) / stripRows;
+  auto forEachStrip = [&](const std::function<void(size_t)> &task) {
+    if (pool) {
+      pool->parallelFor(stripCount, task);
+    } else {
+      for (size_t strip = 0; strip < stripCount; ++strip) {
+        task(strip);
+      }
+    }
+  };
+
+  // Each strip only links cells inside of it, so strips do not share
+  // any part of the forest
+  std::vector<uint32_t> parent(labels.size(), none);
+  forEachStrip([&](size_t strip) {
+    unsigned int top = strip * stripRows;
+    unsigned int bottom = std::min(top + stripRows, height);
+    for (unsigned int y = top; y < bottom; ++y) {
+      for (unsigned int x = 0; x < width; ++x) {
+        if (!isOpen(x, y)) {
+          continue;
+        }
+        uint32_t cell = y * width + x;
+        parent[cell] = cell;
+        if (x > 0 && isOpen(x - 1, y)) {
+          unite(parent, cell, cell - 1);
+        }
+        if (y > top && isOpen(x, y - 1)) {
+          unite(parent, cell, cell - width);
+        }
+      }
+    }
+  });
+
+  for (unsigned int top = stripRows; top < height; top += stripRows) {
+    for (unsigned int x = 0; x < width; ++x) {
+      if (isOpen(x, top) && isOpen(x, top - 1)) {
+        unite(parent, top * width + x, (top - 1) * width + x);
+      }
+    }
+  }
+
+  // The forest no longer changes, strips may follow chains into others
+  std::vector<size_t> roots(stripCount, 0);
+  forEachStrip([&](size_t strip) {
+    unsigned int top = strip * stripRows;
+    unsigned int bottom = std::min(top + stripRows, height);
+    for (uint32_t cell = top * width; cell < bottom * width; ++cell) {
+      if (parent[cell] == none) {
+        continue;
+      }
+      auto root = cell;
+      while (parent[root] != root) {
+        root = parent[root];
+      }
+      labels[cell] = root;
+      roots[strip] += root == cell;
+    }
+  });
+  for (auto stripRoots : roots) {
+    areaCount += stripRoots;
+  }
+}
+
+uint32_t ConnectedComponents::labelAt(const Point &point) const {
+  if (point.x < 0 || point.y < 0 || point.x >= static_cast<int>(width) ||
+      point.y >= static_cast<int>(height)) {
+    return none;
+  }
+  return labels[point.y * width + point.x];
+}
+
+bool ConnectedComponents::connected(const Point &first,
+                                    const Point &second) const {
+  auto label = labelAt(first);
+  return label != none && label == labelAt(second);
+}
@@ -0,0 +1,39 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "utils/grid.h"
+#include "utils/point.h"
+#include "utils/worker_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ConnectedComponents {
+  /**
+   * @brief Areas of a grid connected through cells that are not walls.
+   * Cells are labelled with union-find in strips of rows, in parallel when
+   * a worker pool is given, then the strips are joined along their borders
+   * and every cell is labelled with the root of its set. Sets are always
+   * rooted at their first cell in row order, so the labels do not depend
+   * on the number of threads. Asking whether two cells are connected is
+   * then a comparison of their labels.
+   */
+public:
+  static constexpr uint32_t none = UINT32_MAX; // label of walls
+  static constexpr unsigned int stripRows = 64;
+
+  explicit ConnectedComponents(const Grid &grid, WorkerPool *pool = nullptr);
+
+  // Index of the first cell of the area holding point, row by row
+  uint32_t labelAt(const Point &point) const;
+  bool connected(const Point &first, const Point &second) const;
+  size_t count() const { return areaCount; }
+
+private:
+  unsigned int width;
+  unsigned int height;
+  std::vector<uint32_t> labels;
+  size_t areaCount = 0;
+};
+
+#endif // CONNECTED_COMPONENTS_H
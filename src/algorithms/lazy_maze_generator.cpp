@@ -0,0 +1,128 @@
+#include "lazy_maze_generator.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+LazyMazeGenerator::LazyMazeGenerator(unsigned int _width, unsigned int _height,
+                                     unsigned int seed)
+    : width(_width), height(_height),
+      cellColumns(_width >= 3 ? (_width - 1) / 2 : 0),
+      cellRows(_height >= 3 ? (_height - 1) / 2 : 0), random_engine(seed),
+      sets(cellColumns, 0), parent(cellColumns, 0) {}
+
+std::vector<std::string> LazyMazeGenerator::generateRows(unsigned int rows) {
+  std::vector<std::string> generated;
+  while (generatedRows < std::min(rows, height)) {
+    generated.push_back(nextRow());
+  }
+  return generated;
+}
+
+size_t LazyMazeGenerator::stateBytes() const {
+  return (sets.capacity() + parent.capacity()) * sizeof(unsigned int) +
+         below.capacity();
+}
+
+std::pair<unsigned int, unsigned int> LazyMazeGenerator::getStart() const {
+  return std::make_pair(1, 1);
+}
+
+std::pair<unsigned int, unsigned int> LazyMazeGenerator::getEnd() const {
+  return std::make_pair(width - 2, height - 2);
+}
+
+std::string LazyMazeGenerator::nextRow() {
+  auto y = generatedRows++;
+  std::string row(width, '#');
+  std::uniform_int_distribution<int> coin(0, 1);
+
+  if (y % 2 == 1 && (y - 1) / 2 < cellRows) {
+    // A row of cells, neighbours in different sets are joined at random,
+    // in the last row always
+    bool last = (y - 1) / 2 == cellRows - 1;
+    for (unsigned int i = 0; i < cellColumns; ++i) {
+      if (sets[i] == 0) {
+        sets[i] = nextSet++;
+      }
+      row[2 * i + 1] = ' ';
+    }
+    // Joined sets are linked in a union-find over the columns, rooted in a
+    // column that holds the label the set keeps, instead of relabelling
+    // the whole row at every join
+    std::unordered_map<unsigned int, unsigned int> firstColumn;
+    for (unsigned int i = 0; i < cellColumns; ++i) {
+      parent[i] = firstColumn.emplace(sets[i], i).first->second;
+    }
+    for (unsigned int i = 0; i + 1 < cellColumns; ++i) {
+      auto left = findSet(i);
+      auto right = findSet(i + 1);
+      if (left != right && (last || coin(random_engine))) {
+        parent[right] = left;
+        row[2 * i + 2] = ' ';
+      }
+    }
+    for (unsigned int i = 0; i < cellColumns; ++i) {
+      sets[i] = sets[findSet(i)];
+    }
+
+    // Every set continues down at least once, cells that do not start a
+    // new set in the next row
+    below.assign(width, '#');
+    if (!last) {
+      std::map<unsigned int, std::vector<unsigned int>> members;
+      for (unsigned int i = 0; i < cellColumns; ++i) {
+        members[sets[i]].push_back(i);
+      }
+      std::vector<bool> down(cellColumns, false);
+      for (const auto &[set, cells] : members) {
+        bool any = false;
+        for (auto cell : cells) {
+          if (coin(random_engine)) {
+            down[cell] = true;
+            any = true;
+          }
+        }
+        if (!any) {
+          down[cells[random_engine() % cells.size()]] = true;
+        }
+      }
+      for (unsigned int i = 0; i < cellColumns; ++i) {
+        if (down[i]) {
+          below[2 * i + 1] = ' ';
+        } else {
+          sets[i] = 0;
+        }
+      }
+    }
+  } else if (y % 2 == 0 && y >= 2 && (y - 2) / 2 < cellRows) {
+    row = below;
+  }
+
+  carveEnd(y, row);
+  return row;
+}
+
+unsigned int LazyMazeGenerator::findSet(unsigned int column) {
+  while (parent[column] != column) {
+    parent[column] = parent[parent[column]];
+    column = parent[column];
+  }
+  return column;
+}
+
+void LazyMazeGenerator::carveEnd(unsigned int y, std::string &row) const {
+  // On even sizes the end is off the cell lattice, connect it to the
+  // nearest cell
+  if (cellColumns == 0 || cellRows == 0) {
+    return;
+  }
+  auto [endX, endY] = getEnd();
+  auto cellX = endX % 2 == 1 ? endX : endX - 1;
+  auto cellY = endY % 2 == 1 ? endY : endY - 1;
+  if (y > cellY && y <= endY) {
+    row[cellX] = ' ';
+  }
+  if (y == endY) {
+    std::fill(row.begin() + cellX, row.begin() + endX + 1, ' ');
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef LAZY_MAZE_GENERATOR_H
+#define LAZY_MAZE_GENERATOR_H
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class LazyMazeGenerator {
+  /**
+   * @brief Generates a maze a row at a time with Eller's algorithm.
+   * Maze cells sit at odd coordinates with walls in between. Only the sets
+   * of connected cells in the current row are kept, so rows can be asked
+   * for as they are needed and a huge maze is never held twice. The last
+   * row joins every set, so the maze is perfect: every cell, and with it
+   * the end, is reachable from the start whichever part was generated
+   * first. The same seed gives the same maze as a whole or piece by piece.
+   */
+public:
+  LazyMazeGenerator(unsigned int width, unsigned int height,
+                    unsigned int seed);
+
+  // Generates until the first rows of the map are done, returns the new
+  // ones with '#' for walls and ' ' for passages, like MazeGenerator::getMaze
+  std::vector<std::string> generateRows(unsigned int rows);
+
+  unsigned int getGeneratedRows() const { return generatedRows; }
+  bool isFinished() const { return generatedRows == height; }
+  // Bytes of the row state carried from one row to the next
+  size_t stateBytes() const;
+  std::pair<unsigned int, unsigned int> getStart() const;
+  std::pair<unsigned int, unsigned int> getEnd() const;
+
+private:
+  unsigned int width;
+  unsigned int height;
+  unsigned int cellColumns; // maze cells per row
+  unsigned int cellRows;    // rows of maze cells
+  unsigned int generatedRows = 0;
+  std::default_random_engine random_engine;
+  std::vector<unsigned int> sets; // set of every cell in the next row
+  std::vector<unsigned int> parent; // union-find of the current row
+  unsigned int nextSet = 1;
+  std::string below; // passages down from the last row of cells
+
+  std::string nextRow();
+  unsigned int findSet(unsigned int column);
+  void carveEnd(unsigned int y, std::string &row) const;
+};
+
+#endif // LAZY_MAZE_GENERATOR_H
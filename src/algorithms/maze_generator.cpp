@@ -1,4 +1,19 @@
 #include "maze_generator.h"
+#include "bsp_rooms_generator.h"
+#include "lazy_maze_generator.h"
+
+MazeGeneratorAlgorithm parseMazeGeneratorAlgorithm(const std::string &name) {
+  if (name == "prim") {
+    return MazeGeneratorAlgorithm::RandomizedPrim;
+  }
+  if (name == "ellers") {
+    return MazeGeneratorAlgorithm::Ellers;
+  }
+  if (name == "bsp") {
+    return MazeGeneratorAlgorithm::BspRooms;
+  }
+  return MazeGeneratorAlgorithm::DepthFirstSearch;
+}
 
 auto MazeGenerator::getNeighbors(unsigned int x, unsigned int y) const
     -> std::vector<std::pair<unsigned int, unsigned int>> {
@@ -36,7 +51,7 @@ void MazeGenerator::generateRecursiveDFS() {
    */
   std::pair<unsigned int, unsigned int> current = this->start;
   std::vector<std::pair<unsigned int, unsigned int>> stack = {current};
-  std::default_random_engine random_engine(time(0));
+  std::default_random_engine random_engine(seed);
   while (!stack.empty()) {
     current = stack.back();
     if (current == this->end) {
@@ -68,7 +83,7 @@ void MazeGenerator::generateRandomizedPrim() {
       queue;
   std::pair<unsigned int, unsigned int> current = this->start;
   queue.push(std::make_pair(0, current));
-  std::default_random_engine random_engine(time(0));
+  std::default_random_engine random_engine(seed);
   std::uniform_int_distribution<size_t> distribution(0, 100);
   while (!queue.empty()) {
     auto currentDistance = queue.top().first;
@@ -93,17 +108,20 @@ void MazeGenerator::generateRandomizedPrim() {
 }
 
 MazeGenerator::MazeGenerator(int width, int height,
-                             MazeGeneratorAlgorithm algorithm) {
+                             MazeGeneratorAlgorithm algorithm,
+                             unsigned int seed) {
   /**
    * @brief Constructs a new MazeGenerator object.
    * @param width The width of the maze.
    * @param height The height of the maze.
    * @param algorithm The algorithm to use to generate the maze.
+   * @param seed The seed of the random choices.
    * @return MazeGenerator object.
    */
   this->width = width;
   this->height = height;
   this->algorithm = algorithm;
+  this->seed = seed;
   this->maze = std::vector<std::string>(height, std::string(width, '#'));
   this->start = std::make_pair(1, 1);
   this->end = std::make_pair(width - 2, height - 2);
@@ -114,6 +132,17 @@ MazeGenerator::MazeGenerator(int width, int height,
   case MazeGeneratorAlgorithm::RandomizedPrim:
     this->generateRandomizedPrim();
     break;
+  case MazeGeneratorAlgorithm::Ellers:
+    this->maze = LazyMazeGenerator(width, height, seed).generateRows(height);
+    break;
+  case MazeGeneratorAlgorithm::BspRooms: {
+    BspRoomsGenerator rooms(width, height, seed);
+    this->maze = rooms.getMaze();
+    this->start = rooms.getStart();
+    this->end = rooms.getEnd();
+    this->rooms = rooms.getRooms();
+    break;
+  }
   default:
     // throw exception not implemented
     throw "Not implemented";
@@ -143,3 +172,11 @@ auto MazeGenerator::getEnd() -> std::pair<unsigned int, unsigned int> {
    */
   return this->end;
 }
+
+auto MazeGenerator::getRooms() -> std::vector<Room> {
+  /**
+   * @brief Returns the rooms of the level.
+   * @return The rooms, empty for mazes.
+   */
+  return this->rooms;
+}
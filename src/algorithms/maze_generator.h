@@ -1,7 +1,9 @@
 #ifndef _HOME_ADAM_MYSTERIOUS_DUNGEON_SRC_MAZE_GENERATOR_H
 #define _HOME_ADAM_MYSTERIOUS_DUNGEON_SRC_MAZE_GENERATOR_H
 
+#include "room_graph.h"
 #include <algorithm>
+#include <ctime>
 #include <iostream>
 #include <queue>
 #include <random>
@@ -27,23 +29,31 @@ enum class MazeGeneratorAlgorithm {
   HuntAndKillHexagonal,
   WilsonsHexagonal,
   DepthFirstSearchHexagonal,
+  Ellers,
+  BspRooms,
   Unknown
 };
 
+// "dfs", "prim", "ellers" or "bsp", anything else is DepthFirstSearch
+MazeGeneratorAlgorithm parseMazeGeneratorAlgorithm(const std::string &name);
+
 class MazeGenerator {
   /**
    * @brief Generates a maze using the recursive backtracking algorithm.
    * @param width The width of the maze.
    * @param height The height of the maze.
    * @param algorithm The algorithm to use.
+   * @param seed Seed of the random choices, the same seed gives the same maze.
    */
 private:
   unsigned int width;
   unsigned int height;
   MazeGeneratorAlgorithm algorithm;
+  unsigned int seed;
   std::vector<std::string> maze;
   std::pair<unsigned int, unsigned int> start;
   std::pair<unsigned int, unsigned int> end;
+  std::vector<Room> rooms;
 
   std::vector<std::pair<unsigned int, unsigned int>>
   getNeighbors(unsigned int x, unsigned int y) const;
@@ -51,9 +61,11 @@ private:
   void generateRandomizedPrim();
 
 public:
-  MazeGenerator(int width, int height, MazeGeneratorAlgorithm algorithm);
+  MazeGenerator(int width, int height, MazeGeneratorAlgorithm algorithm,
+                unsigned int seed = static_cast<unsigned int>(time(0)));
   std::vector<std::string> getMaze();
   std::pair<unsigned int, unsigned int> getStart();
   std::pair<unsigned int, unsigned int> getEnd();
+  std::vector<Room> getRooms();
 };
 #endif
@@ -0,0 +1,113 @@
+#include "poisson_disk_sampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+PoissonDiskSampler::PoissonDiskSampler(
+    unsigned int _width, unsigned int _height,
+    std::function<bool(const Point &)> _isFree, unsigned int seed)
+    : width(_width), height(_height), isFree(std::move(_isFree)),
+      random_engine(seed) {}
+
+std::vector<Point> PoissonDiskSampler::sample(size_t count,
+                                              double minDistance) {
+  std::vector<Point> samples;
+  if (count == 0 || minDistance < 1 || width == 0 || height == 0) {
+    return samples;
+  }
+
+  // Two points in one bucket would be closer than minDistance
+  const double bucketSize = minDistance / std::sqrt(2.0);
+  const int columns = static_cast<int>(std::ceil(width / bucketSize));
+  const int rows = static_cast<int>(std::ceil(height / bucketSize));
+  std::vector<int32_t> buckets(static_cast<size_t>(columns) * rows, -1);
+  const double squaredDistance = minDistance * minDistance;
+
+  auto fits = [&](const Point &point) {
+    if (point.x < 0 || point.y < 0 || point.x >= static_cast<int>(width) ||
+        point.y >= static_cast<int>(height)) {
+      return false;
+    }
+    int column = static_cast<int>(point.x / bucketSize);
+    int row = static_cast<int>(point.y / bucketSize);
+    for (int y = std::max(row - 2, 0); y <= std::min(row + 2, rows - 1);
+         ++y) {
+      for (int x = std::max(column - 2, 0);
+           x <= std::min(column + 2, columns - 1); ++x) {
+        auto other = buckets[y * columns + x];
+        if (other < 0) {
+          continue;
+        }
+        double dx = samples[other].x - point.x;
+        double dy = samples[other].y - point.y;
+        if (dx * dx + dy * dy < squaredDistance) {
+          return false;
+        }
+      }
+    }
+    // Last, as the level is slower to ask than the buckets
+    return isFree(point);
+  };
+
+  std::vector<int32_t> active;
+  auto accept = [&](const Point &point) {
+    auto index = static_cast<int32_t>(samples.size());
+    buckets[static_cast<int>(point.y / bucketSize) * columns +
+            static_cast<int>(point.x / bucketSize)] = index;
+    active.push_back(index);
+    samples.push_back(point);
+  };
+
+  // Candidates are drawn from the cell offsets between one and two
+  // minimum distances away, which on a grid are few enough to list
+  std::vector<Point> offsets;
+  auto reach = static_cast<int>(2 * minDistance);
+  for (int y = -reach; y <= reach; ++y) {
+    for (int x = -reach; x <= reach; ++x) {
+      double distance = std::sqrt(x * x + y * y);
+      if (distance >= minDistance && distance <= 2 * minDistance) {
+        offsets.emplace_back(x, y);
+      }
+    }
+  }
+
+  std::uniform_int_distribution<int> randomX(0, width - 1);
+  std::uniform_int_distribution<int> randomY(0, height - 1);
+  std::uniform_int_distribution<size_t> randomOffset(0, offsets.size() - 1);
+  // Random darts spread the first points over the whole level, until
+  // they keep missing. Growing around the points then fills the gaps
+  // between them. Darts are thrown again whenever nothing is left to grow
+  // from, as the level may have areas too far apart to grow into
+  int missedDarts = 0;
+  while (samples.size() < count && missedDarts < attempts * attempts) {
+    if (missedDarts < attempts || active.empty()) {
+      Point dart(randomX(random_engine), randomY(random_engine));
+      if (fits(dart)) {
+        accept(dart);
+        missedDarts = 0;
+      } else {
+        ++missedDarts;
+      }
+      continue;
+    }
+
+    std::uniform_int_distribution<size_t> randomActive(0, active.size() - 1);
+    auto slot = randomActive(random_engine);
+    auto centre = samples[active[slot]];
+    bool accepted = false;
+    for (int i = 0; i < attempts && !accepted; ++i) {
+      const auto &offset = offsets[randomOffset(random_engine)];
+      Point candidate(centre.x + offset.x, centre.y + offset.y);
+      if (fits(candidate)) {
+        accept(candidate);
+        accepted = true;
+      }
+    }
+    if (!accepted) {
+      active[slot] = active.back();
+      active.pop_back();
+    }
+  }
+  return samples;
+}
@@ -0,0 +1,40 @@
+#ifndef POISSON_DISK_SAMPLER_H
+#define POISSON_DISK_SAMPLER_H
+
+#include "utils/point.h"
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <vector>
+
+class PoissonDiskSampler {
+  /**
+   * @brief Spreads points over the free cells of a level, keeping them a
+   * minimum distance apart (Poisson disk sampling after Bridson).
+   * Points are first thrown at random cells, which covers the whole level
+   * evenly, until attempts throws in a row have missed. The gaps left are
+   * then filled by growing around the points: each one stays active until
+   * attempts random candidates between one and two minimum distances away
+   * from it have all been rejected. A background grid with buckets small
+   * enough to hold a single point makes checking a candidate look at no
+   * more than 25 points, however many there are.
+   */
+public:
+  static constexpr int attempts = 30;
+
+  PoissonDiskSampler(unsigned int width, unsigned int height,
+                     std::function<bool(const Point &)> isFree,
+                     unsigned int seed);
+
+  // Up to count free points, at least minDistance apart from each other.
+  // Fewer when the level has no room for more, none below a distance of 1
+  std::vector<Point> sample(size_t count, double minDistance);
+
+private:
+  unsigned int width;
+  unsigned int height;
+  std::function<bool(const Point &)> isFree;
+  std::default_random_engine random_engine;
+};
+
+#endif // POISSON_DISK_SAMPLER_H
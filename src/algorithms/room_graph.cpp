@@ -0,0 +1,188 @@
+#include "room_graph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+
+RoomGraph::RoomGraph(unsigned int _width, unsigned int _height,
+                     const std::function<bool(const Point &)> &isWall,
+                     std::vector<Room> _rooms)
+    : width(_width), height(_height), rooms(std::move(_rooms)),
+      roomOfCell(static_cast<size_t>(_width) * _height, -1),
+      links(rooms.size()) {
+  for (size_t room = 0; room < rooms.size(); ++room) {
+    const auto &area = rooms[room];
+    for (int y = std::max(area.y, 0);
+         y < std::min<int>(area.y + area.height, height); ++y) {
+      for (int x = std::max(area.x, 0);
+           x < std::min<int>(area.x + area.width, width); ++x) {
+        if (!isWall(Point(x, y))) {
+          roomOfCell[y * width + x] = static_cast<int>(room);
+        }
+      }
+    }
+  }
+  traceCorridors(isWall);
+}
+
+int RoomGraph::roomAt(const Point &point) const {
+  if (point.x < 0 || point.y < 0 || point.x >= static_cast<int>(width) ||
+      point.y >= static_cast<int>(height)) {
+    return -1;
+  }
+  return roomOfCell[point.y * width + point.x];
+}
+
+void RoomGraph::traceCorridors(
+    const std::function<bool(const Point &)> &isWall) {
+  const Point steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  auto isCorridor = [&](const Point &point) {
+    return point.x >= 0 && point.y >= 0 && point.x < static_cast<int>(width) &&
+           point.y < static_cast<int>(height) && !isWall(point) &&
+           roomAt(point) == -1;
+  };
+
+  std::vector<bool> traced(roomOfCell.size(), false);
+  std::vector<int> distance(roomOfCell.size(), -1);
+  // Shortest link found so far for every pair of rooms, lower room first
+  std::map<std::pair<int, int>, Link> shortest;
+
+  for (unsigned int startY = 0; startY < height; ++startY) {
+    for (unsigned int startX = 0; startX < width; ++startX) {
+      Point start(startX, startY);
+      if (traced[startY * width + startX] || !isCorridor(start)) {
+        continue;
+      }
+
+      // One corridor, possibly branching, and the doors along it
+      std::vector<Point> cells = {start};
+      std::vector<Door> corridorDoors;
+      traced[startY * width + startX] = true;
+      for (size_t i = 0; i < cells.size(); ++i) {
+        auto cell = cells[i];
+        for (const auto &step : steps) {
+          auto next = cell + step;
+          auto room = roomAt(next);
+          if (room != -1) {
+            corridorDoors.push_back({cell, room});
+          } else if (isCorridor(next) && !traced[next.y * width + next.x]) {
+            traced[next.y * width + next.x] = true;
+            cells.push_back(next);
+          }
+        }
+      }
+      doors.insert(doors.end(), corridorDoors.begin(), corridorDoors.end());
+
+      // Walks from every door to the doors of the other rooms
+      for (const auto &door : corridorDoors) {
+        std::queue<Point> frontier;
+        frontier.push(door.point);
+        distance[door.point.y * width + door.point.x] = 0;
+        while (!frontier.empty()) {
+          auto cell = frontier.front();
+          frontier.pop();
+          for (const auto &step : steps) {
+            auto next = cell + step;
+            if (isCorridor(next) && distance[next.y * width + next.x] == -1) {
+              distance[next.y * width + next.x] =
+                  distance[cell.y * width + cell.x] + 1;
+              frontier.push(next);
+            }
+          }
+        }
+
+        for (const auto &other : corridorDoors) {
+          if (other.room <= door.room) {
+            continue;
+          }
+          auto length = distance[other.point.y * width + other.point.x];
+          auto key = std::make_pair(door.room, other.room);
+          auto found = shortest.find(key);
+          if (found == shortest.end() || length < found->second.length) {
+            shortest[key] = {other.room, door.point, other.point, length};
+          }
+        }
+        for (const auto &cell : cells) {
+          distance[cell.y * width + cell.x] = -1;
+        }
+      }
+    }
+  }
+
+  for (const auto &[ends, link] : shortest) {
+    links[ends.first].push_back(link);
+    links[ends.second].push_back(
+        {ends.first, link.entry, link.exit, link.length});
+  }
+}
+
+std::vector<int> RoomGraph::linksTowards(int destination) const {
+  // Dijkstra outwards from the destination, a link costs its corridor plus
+  // the way across the room it leads to
+  std::vector<long> cost(rooms.size(), std::numeric_limits<long>::max());
+  std::vector<int> next(rooms.size(), -1);
+  using Entry = std::pair<long, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  cost[destination] = 0;
+  queue.push({0, destination});
+
+  while (!queue.empty()) {
+    auto [roomCost, room] = queue.top();
+    queue.pop();
+    if (roomCost > cost[room]) {
+      continue;
+    }
+    auto centre = rooms[room].centre();
+    for (const auto &link : links[room]) {
+      auto otherCentre = rooms[link.to].centre();
+      auto linkCost = roomCost + link.length +
+                      std::abs(centre.x - otherCentre.x) +
+                      std::abs(centre.y - otherCentre.y);
+      if (linkCost < cost[link.to]) {
+        cost[link.to] = linkCost;
+        const auto &back = links[link.to];
+        next[link.to] = static_cast<int>(
+            std::find_if(back.begin(), back.end(),
+                         [room = room](const Link &candidate) {
+                           return candidate.to == room;
+                         }) -
+            back.begin());
+        queue.push({linkCost, link.to});
+      }
+    }
+  }
+  return next;
+}
+
+std::vector<Point> RoomGraph::route(const Point &from, const Point &to) const {
+  auto room = roomAt(from);
+  auto destination = roomAt(to);
+  if (room == -1 || destination == -1 || room == destination) {
+    return {};
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = nextLinks.find(destination);
+  if (found == nextLinks.end()) {
+    found = nextLinks.emplace(destination, linksTowards(destination)).first;
+  }
+  const auto &next = found->second;
+  if (next[room] == -1) {
+    return {};
+  }
+
+  std::vector<Point> doorsOnTheWay;
+  while (room != destination) {
+    const auto &link = links[room][next[room]];
+    for (const auto &door : {link.exit, link.entry}) {
+      // Rooms one wall apart share their door
+      if (doorsOnTheWay.empty() || doorsOnTheWay.back() != door) {
+        doorsOnTheWay.push_back(door);
+      }
+    }
+    room = link.to;
+  }
+  return doorsOnTheWay;
+}
@@ -0,0 +1,81 @@
+#ifndef ROOM_GRAPH_H
+#define ROOM_GRAPH_H
+
+#include "utils/point.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct Room {
+  int x;
+  int y;
+  int width;
+  int height;
+
+  bool contains(const Point &point) const {
+    return point.x >= x && point.x < x + width && point.y >= y &&
+           point.y < y + height;
+  }
+  Point centre() const { return Point(x + width / 2, y + height / 2); }
+};
+
+class RoomGraph {
+  /**
+   * @brief Rooms of a level and the corridors between them.
+   * A door is a corridor cell next to a room. Corridors are traced from
+   * door to door once, when the graph is built, and every pair of rooms a
+   * corridor joins becomes a link with the length of the shortest walk
+   * between their doors. route() then answers long-distance queries on
+   * the rooms alone: for every destination room the link to take from
+   * each other room is computed on first use and kept, so later routes to
+   * the same room are a walk along the links. Pathfinding only has to
+   * search between consecutive doors of the route.
+   */
+public:
+  struct Door {
+    Point point;
+    int room;
+  };
+
+  struct Link {
+    int to;      // room at the other end
+    Point exit;  // door of this room
+    Point entry; // door of room to
+    int length;  // steps from exit to entry
+  };
+
+  RoomGraph(unsigned int width, unsigned int height,
+            const std::function<bool(const Point &)> &isWall,
+            std::vector<Room> rooms);
+
+  // Index of the room holding point, -1 outside of every room
+  int roomAt(const Point &point) const;
+  const std::vector<Room> &getRooms() const { return rooms; }
+  const std::vector<Door> &getDoors() const { return doors; }
+  const std::vector<Link> &getLinks(int room) const { return links[room]; }
+
+  // Doors to walk through from the room of from to the room of to, the
+  // exit of every room followed by the entry of the next. Empty when both
+  // are in the same room, either is outside of the rooms or no corridors
+  // join them.
+  std::vector<Point> route(const Point &from, const Point &to) const;
+
+private:
+  unsigned int width;
+  unsigned int height;
+  std::vector<Room> rooms;
+  std::vector<int> roomOfCell; // row by row
+  std::vector<Door> doors;
+  std::vector<std::vector<Link>> links; // by room
+
+  // Per destination room, the index of the link each room leaves by, -1
+  // where the destination cannot be reached
+  mutable std::unordered_map<int, std::vector<int>> nextLinks;
+  mutable std::mutex mutex;
+
+  void traceCorridors(const std::function<bool(const Point &)> &isWall);
+  std::vector<int> linksTowards(int destination) const;
+};
+
+#endif // ROOM_GRAPH_H
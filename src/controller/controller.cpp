@@ -1,10 +1,13 @@
 #include "controller.h"
-#include <chrono>
-#include <thread>
+#include "utils/event_logger.h"
+#include "utils/profiler.h"
+
+// How long a dynamic state waits for input before the next frame
+const int frameIntervalMs = 50;
 
 Controller::Controller(Model &m, Renderer &r)
-    : model(m), renderer(r), isRunning(false),
-      currentGameState(GameState::MAIN_MENU) {
+    : model(m), renderer(r), isRunning(false), showDebugOverlay(false),
+      needsRedraw(false), currentGameState(GameState::MAIN_MENU) {
   gameStateHandlers.emplace(GameState::MAIN_MENU,
                             std::make_unique<MainMenuStateHandler>());
   gameStateHandlers.emplace(GameState::GAMEPLAY,
@@ -18,14 +21,27 @@ Controller::Controller(Model &m, Renderer &r)
 
 void Controller::run() {
   keypad(stdscr, TRUE);
-  nodelay(stdscr, TRUE); // non-blocking input
   isRunning = true;
+  currentHandler().onEnter(*this);
 
   while (isRunning) {
-    handleGameState();
+    auto &handler = currentHandler();
+
+    // Static states only change in response to input: they draw once when
+    // entered and then block in getch() until a key arrives, instead of
+    // redrawing the same screen every frame. The world under them still
+    // ticks every frame while other players are in it.
+    if (!handler.isStatic() || needsRedraw) {
+      needsRedraw = false;
+      handleGameState();
+    } else if (worldKeepsRunning()) {
+      model.update();
+    }
+
+    timeout(currentHandler().isStatic() && !worldKeepsRunning()
+                ? -1
+                : frameIntervalMs);
     handleInput();
-    // Sleep for 50 milliseconds
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
   }
 }
 
@@ -33,23 +49,31 @@ void Controller::setState(GameState gameState) {
   if (!gameStateHandlers.count(gameState)) {
     return;
   }
+  EventLogger::getInstance().log(EventType::STATE_CHANGED,
+                                 static_cast<int32_t>(currentGameState),
+                                 static_cast<int32_t>(gameState));
+  currentHandler().onExit(*this);
   currentGameState = gameState;
+  currentHandler().onEnter(*this);
 }
 
-void Controller::handleGameState() {
-  if (auto handler = gameStateHandlers.find(currentGameState);
-      handler != gameStateHandlers.end()) {
-    handler->second->handleState(*this);
-  }
+bool Controller::worldKeepsRunning() {
+  return currentHandler().showsWorld() && model.hasRemotePlayers();
 }
 
+GameStateHandler &Controller::currentHandler() {
+  return *gameStateHandlers.at(currentGameState);
+}
+
+void Controller::handleGameState() { currentHandler().handleState(*this); }
+
 void Controller::handleInput() {
+  Profiler::PhaseScope phase(ProfilePhase::INPUT);
   int ch = getch();
-  if (ch != ERR) {
-    if (auto handler = gameStateHandlers.find(currentGameState);
-        handler != gameStateHandlers.end()) {
-      handler->second->handleInput(*this, ch);
-    }
+  if (ch == KEY_RESIZE) {
+    needsRedraw = true;
+  } else if (ch != ERR) {
+    currentHandler().handleInput(*this, ch);
     flushinp(); // clear the input buffer
   }
 }
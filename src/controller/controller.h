@@ -21,9 +21,15 @@ public:
   Model &model;
   Renderer &renderer;
   bool isRunning;
+  bool showDebugOverlay;
 
 private:
   std::map<GameState, std::unique_ptr<GameStateHandler>> gameStateHandlers;
+  bool needsRedraw; // set on terminal resizes
+
+  GameStateHandler &currentHandler();
+  // The host is paused or dead while others still play
+  bool worldKeepsRunning();
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "game_state_handler.h"
 #include "renderer/renderer_data.h"
+#include "utils/memory_tracker.h"
+#include "utils/metrics.h"
 
 enum class GameplayControls {
   QUIT = 'q',
@@ -16,28 +18,65 @@ enum class GameplayControls {
   ENTER = '\n', // or '\r' depending on the system
   SPACE = '\0',
   INC_MSG_INDEX = 'k',
-  DEC_MSG_INDEX = 'i'
+  DEC_MSG_INDEX = 'i',
+  DEBUG_OVERLAY = 'o'
 };
 
 enum class MainMenuOptions { START_GAME = '1', OPTIONS = '2', QUIT = '3' };
 
-void MainMenuStateHandler::handleState(Controller &controller) {
-  Renderer &renderer = controller.renderer;
-  renderer.setState(GameState::MAIN_MENU);
-  std::vector<std::vector<CellType>> emptyGrid;
-  std::unordered_map<std::string, std::string> emptyStats;
-  Point emptyPos;
+static std::vector<std::string> collectDebugInfo() {
+  std::vector<std::string> lines;
+  const auto &tracker = MemoryTracker::getInstance();
 
+  lines.push_back("Memory (live / peak)");
+  for (const auto &usage : tracker.getUsage()) {
+    lines.push_back(MemoryTracker::tagName(usage.tag) + ": " +
+                    MemoryTracker::formatBytes(usage.liveBytes) + " / " +
+                    MemoryTracker::formatBytes(usage.peakBytes));
+  }
+  lines.push_back("Total: " +
+                  MemoryTracker::formatBytes(tracker.getTotalLiveBytes()));
+
+  auto &metrics = MetricsRegistry::getInstance();
+  const auto &tickDuration = metrics.histogram(
+      "md_tick_duration_seconds", "Duration of Model::update", 1e-9);
+  lines.push_back("Tick p50/p99: " +
+                  std::to_string(tickDuration.percentile(50) / 1000) + " / " +
+                  std::to_string(tickDuration.percentile(99) / 1000) + " us");
+  lines.push_back(
+      "A* calls: " +
+      std::to_string(metrics.counter("md_astar_calls_total", "").get()) +
+      ", expanded: " +
+      std::to_string(
+          metrics.counter("md_astar_node_expansions_total", "").get()));
+  lines.push_back(
+      "Frames: " +
+      std::to_string(metrics.counter("md_frames_drawn_total", "").get()) +
+      ", terminal: " +
+      MemoryTracker::formatBytes(
+          metrics.counter("md_terminal_bytes_written_total", "").get()));
+
+  return lines;
+}
+
+MainMenuStateHandler::MainMenuStateHandler() : menuOptions(3) {
   std::map<MainMenuOptions, std::string> mainMenuOptions = {
       {MainMenuOptions::START_GAME, "1. Start Game"},
       {MainMenuOptions::OPTIONS, "2. Options"},
       {MainMenuOptions::QUIT, "3. Quit"}};
 
-  InfoDeque menuOptions(mainMenuOptions.size());
   for (const auto &option : mainMenuOptions) {
     menuOptions.addMessage({option.second}); // put the option into a vector
   }
+}
 
+void MainMenuStateHandler::onEnter(Controller &controller) {
+  handleState(controller);
+}
+
+void MainMenuStateHandler::handleState(Controller &controller) {
+  Renderer &renderer = controller.renderer;
+  renderer.setState(GameState::MAIN_MENU);
   renderer.draw(RendererData(emptyGrid, menuOptions, emptyStats, emptyPos));
 }
 
@@ -66,14 +105,40 @@ void GameplayStateHandler::handleState(Controller &controller) {
   auto &renderer = controller.renderer;
   auto stat = model.getPlayerStats();
   renderer.setState(GameState::GAMEPLAY);
-  renderer.draw(
-      RendererData(model.map->grid, *model.info, stat, model.player->position));
+  RendererData data(model.map->grid, *model.info, stat,
+                    model.player->position);
+  data.changedCells = collectChangedCells(model);
+  std::vector<std::string> debugInfo;
+  if (controller.showDebugOverlay) {
+    debugInfo = collectDebugInfo();
+    data.debugInfo = &debugInfo;
+  }
+  renderer.draw(data);
 
   if (model.isGameOver()) {
     controller.setState(GameState::GAME_OVER);
   }
 }
 
+const std::vector<Point> *
+GameplayStateHandler::collectChangedCells(Model &model) {
+  if (journalMap.lock() != model.map) {
+    if (auto previous = journalMap.lock()) {
+      previous->journal.unsubscribe(journalSubscriber);
+    }
+    journalMap = model.map;
+    journalSubscriber = model.map->journal.subscribe();
+  }
+
+  changedCells.clear();
+  auto &journal = model.map->journal;
+  bool incremental =
+      journal.drain(journalSubscriber, [&](const CellChange &change) {
+        changedCells.push_back(change.point);
+      });
+  return incremental ? &changedCells : nullptr;
+}
+
 void GameplayStateHandler::handleInput(Controller &controller, int ch) {
   auto &model = controller.model;
   GameplayControls control = static_cast<GameplayControls>(tolower(ch));
@@ -110,14 +175,25 @@ void GameplayStateHandler::handleInput(Controller &controller, int ch) {
   case GameplayControls::DEC_MSG_INDEX:
     model.info->decreaseStartIndex();
     break;
+  case GameplayControls::DEBUG_OVERLAY:
+    controller.showDebugOverlay = !controller.showDebugOverlay;
+    break;
   default:
     break;
   }
 }
 
+void PauseStateHandler::onEnter(Controller &controller) {
+  handleState(controller);
+}
+
 void PauseStateHandler::handleState(Controller &controller) {
+  auto &model = controller.model;
+  auto stat = model.getPlayerStats();
   auto &renderer = controller.renderer;
   renderer.setState(GameState::PAUSE_MENU);
+  renderer.draw(
+      RendererData(model.map->grid, *model.info, stat, model.player->position));
 }
 
 void PauseStateHandler::handleInput(Controller &controller, int ch) {
@@ -134,6 +210,10 @@ void PauseStateHandler::handleInput(Controller &controller, int ch) {
   }
 }
 
+void GameOverStateHandler::onEnter(Controller &controller) {
+  handleState(controller);
+}
+
 void GameOverStateHandler::handleState(Controller &controller) {
   auto &model = controller.model;
   auto stat = model.getPlayerStats();
@@ -2,37 +2,81 @@
 #define GameStateHandler_H
 
 #include "controller.h"
+#include "model/map.h"
+#include "utils/grid.h"
+#include "utils/info_deque.h"
+#include "utils/point.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class Controller;
+class Model;
 class GameStateHandler {
 public:
   virtual void handleInput(Controller &controller, int input) = 0;
+  // Called every frame for dynamic states. Static states draw their screen
+  // in onEnter, and here again only when the terminal is resized.
   virtual void handleState(Controller &controller) = 0;
+  virtual void onEnter(Controller &controller) {}
+  virtual void onExit(Controller &controller) {}
+  // Static states change only in response to input, so the controller
+  // blocks on input while they are active.
+  virtual bool isStatic() const { return false; }
+  // States shown over the running game. Remote players and bots go on
+  // playing in it, so the controller keeps ticking the world while any
+  // of them is alive.
+  virtual bool showsWorld() const { return false; }
   virtual ~GameStateHandler() = default;
 };
 
 class MainMenuStateHandler : public GameStateHandler {
 public:
+  MainMenuStateHandler();
   void handleInput(Controller &controller, int input) override;
   void handleState(Controller &controller) override;
+  void onEnter(Controller &controller) override;
+  bool isStatic() const override { return true; }
+
+private:
+  InfoDeque menuOptions;
+  Grid emptyGrid;
+  std::unordered_map<std::string, std::string> emptyStats;
+  Point emptyPos;
 };
 
 class GameplayStateHandler : public GameStateHandler {
 public:
   void handleInput(Controller &controller, int input) override;
   void handleState(Controller &controller) override;
+
+private:
+  // Journal subscription of the map drawn last, so each frame redraws only
+  // the cells changed since the previous one
+  std::weak_ptr<Map> journalMap;
+  MapJournal::SubscriberId journalSubscriber = 0;
+  std::vector<Point> changedCells;
+
+  const std::vector<Point> *collectChangedCells(Model &model);
 };
 
 class PauseStateHandler : public GameStateHandler {
 public:
   void handleInput(Controller &controller, int input) override;
   void handleState(Controller &controller) override;
+  void onEnter(Controller &controller) override;
+  bool isStatic() const override { return true; }
+  bool showsWorld() const override { return true; }
 };
 
 class GameOverStateHandler : public GameStateHandler {
 public:
   void handleInput(Controller &controller, int input) override;
   void handleState(Controller &controller) override;
+  void onEnter(Controller &controller) override;
+  bool isStatic() const override { return true; }
+  bool showsWorld() const override { return true; }
 };
 
 // Other state handlers...
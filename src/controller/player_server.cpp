@@ -0,0 +1,149 @@
+#include "player_server.h"
+#include "utils/direction.h"
+#include <cstdio>
+#include <cstdint>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+PlayerServer::PlayerServer(CommandBuffer &commands, const PlayerViews &views)
+    : commands(commands), views(views) {}
+
+PlayerServer::~PlayerServer() { stop(); }
+
+bool PlayerServer::start(const std::string &path) {
+  if (running || path.empty()) {
+    return false;
+  }
+  running = true;
+  server = std::thread(&PlayerServer::serve, this, path);
+  return true;
+}
+
+void PlayerServer::stop() {
+  running = false;
+  if (server.joinable()) {
+    server.join();
+  }
+}
+
+void PlayerServer::serve(const std::string &path) {
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::snprintf(address.sun_path, sizeof(address.sun_path), "%s",
+                path.c_str());
+  unlink(path.c_str());
+
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+          0 ||
+      listen(listener, 16) < 0) {
+    if (listener >= 0) {
+      close(listener);
+    }
+    running = false;
+    return;
+  }
+
+  struct Client {
+    int id;                   // player id
+    uint64_t viewVersion = 0; // of the view taken last
+    std::string unsent;       // rest of that view
+  };
+  // Every connected client, by descriptor
+  std::unordered_map<int, Client> clients;
+
+  auto disconnect = [&](int client) {
+    commands.submit(CommandType::LEAVE, clients.at(client).id);
+    clients.erase(client);
+    close(client);
+  };
+
+  // A view is finished before the next one is taken, so a client reading
+  // slowly skips views but never gets half of one
+  auto sendViews = [&]() {
+    for (auto &[client, state] : clients) {
+      if (state.unsent.empty() &&
+          !views.takeNewer(state.id, state.viewVersion, state.unsent)) {
+        continue;
+      }
+      auto sent = send(client, state.unsent.data(), state.unsent.size(),
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (sent > 0) {
+        state.unsent.erase(0, sent);
+      }
+    }
+  };
+
+  while (running) {
+    std::vector<pollfd> descriptors{{listener, POLLIN, 0}};
+    for (const auto &[client, state] : clients) {
+      descriptors.push_back({client, POLLIN, 0});
+    }
+    // About a frame, views are sent between the polls
+    if (poll(descriptors.data(), descriptors.size(), 50) <= 0) {
+      sendViews();
+      continue;
+    }
+
+    if (descriptors[0].revents & POLLIN) {
+      int client = accept(listener, nullptr, nullptr);
+      if (client >= 0) {
+        clients[client] = {commands.reservePlayerId()};
+        commands.submit(CommandType::JOIN, clients[client].id);
+      }
+    }
+
+    for (size_t i = 1; i < descriptors.size(); ++i) {
+      if (!descriptors[i].revents) {
+        continue;
+      }
+      int client = descriptors[i].fd;
+      char keys[64];
+      auto received = recv(client, keys, sizeof(keys), 0);
+      if (received <= 0) {
+        disconnect(client);
+        continue;
+      }
+
+      bool quit = false;
+      auto id = clients.at(client).id;
+      for (ssize_t k = 0; k < received && !quit; ++k) {
+        switch (keys[k]) {
+        case 'w':
+          commands.submit(CommandType::MOVE, id, Direction::UP);
+          break;
+        case 'a':
+          commands.submit(CommandType::MOVE, id, Direction::LEFT);
+          break;
+        case 's':
+          commands.submit(CommandType::MOVE, id, Direction::DOWN);
+          break;
+        case 'd':
+          commands.submit(CommandType::MOVE, id, Direction::RIGHT);
+          break;
+        case 'q':
+          quit = true;
+          break;
+        default:
+          break;
+        }
+      }
+      if (quit) {
+        disconnect(client);
+      }
+    }
+    sendViews();
+  }
+
+  for (const auto &[client, state] : clients) {
+    close(client);
+  }
+  close(listener);
+  unlink(path.c_str());
+}
@@ -0,0 +1,41 @@
+#ifndef PLAYER_SERVER_H
+#define PLAYER_SERVER_H
+
+#include "model/command_buffer.h"
+#include "model/player_views.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+class PlayerServer {
+  /**
+   * @brief Lets extra players join the dungeon through a Unix socket.
+   * Every connection becomes a player. Its keys (w, a, s, d, q to leave)
+   * are turned into commands for the model's command buffer on the
+   * server's own thread, so remote input never waits for the simulation
+   * and the simulation never waits for a slow client. In return, each
+   * client is sent its view whenever it changed, as text ending in an
+   * empty line: its status, the cells around it, or a notice once it is
+   * dead. Closing the connection also removes the player.
+   */
+public:
+  PlayerServer(CommandBuffer &commands, const PlayerViews &views);
+  ~PlayerServer();
+
+  bool start(const std::string &path);
+  void stop();
+  bool isRunning() const { return running; }
+
+private:
+  CommandBuffer &commands;
+  const PlayerViews &views;
+  std::thread server;
+  std::atomic_bool running{false};
+
+  void serve(const std::string &path);
+
+  PlayerServer(PlayerServer const &) = delete;
+  void operator=(PlayerServer const &) = delete;
+};
+
+#endif // PLAYER_SERVER_H
@@ -1,13 +1,61 @@
 #include "controller/controller.h"
+#include "controller/player_server.h"
 #include "model/model.h"
 #include "renderer/renderer.h"
+#include "utils/event_logger.h"
+#include "utils/global_config.h"
+#include "utils/metrics.h"
+#include "utils/profiler.h"
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char **argv) {
+  // --profile[=path] samples the process with SIGPROF and writes folded
+  // stacks for flamegraph.pl on exit
+  std::string profilePath;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--profile") == 0) {
+      profilePath = "profile.folded";
+    } else if (std::strncmp(argv[i], "--profile=", 10) == 0) {
+      profilePath = argv[i] + 10;
+    }
+  }
+
+  auto &config = GlobalConfig::getInstance();
+  if (config.getConfig<int>("EventLogging", 0)) {
+    EventLogger::getInstance().start(
+        config.getConfig<std::string>("EventLogPath", "events.bin"));
+  }
+  if (config.getConfig<int>("MetricsExport", 0)) {
+    MetricsRegistry::getInstance().startExporter(
+        config.getConfig<std::string>("MetricsExportPath", "metrics.prom"),
+        std::chrono::milliseconds(
+            config.getConfig<int>("MetricsExportIntervalMs", 5000)));
+  }
+
+  if (!profilePath.empty() &&
+      !Profiler::getInstance().start(
+          config.getConfig<int>("ProfilerFrequency", 997))) {
+    std::cerr << "Could not start the profiler, no profile is written to "
+              << profilePath << std::endl;
+  }
 
-int main() {
   Model model;
   Renderer renderer;
 
+  // Extra players connect here, e.g. with socat - UNIX-CONNECT:players.sock
+  PlayerServer playerServer(model.commands, model.views);
+  playerServer.start(config.getConfig<std::string>("PlayerSocket", ""));
+
   Controller controller(model, renderer);
   controller.run();
+  if (Profiler::getInstance().isRunning()) {
+    Profiler::getInstance().stop();
+    Profiler::getInstance().writeFoldedStacks(profilePath);
+  }
+  playerServer.stop();
+  MetricsRegistry::getInstance().stopExporter();
+  EventLogger::getInstance().stop();
 
   return 0;
 }
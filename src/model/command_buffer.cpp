@@ -0,0 +1,69 @@
+#include "command_buffer.h"
+#include "utils/metrics.h"
+#include <algorithm>
+
+CommandBuffer::CommandBuffer(size_t maxMovesPerPlayer)
+    : maxMovesPerPlayer(maxMovesPerPlayer) {}
+
+CommandBuffer::CommandBuffer(const CommandBuffer &other)
+    : maxMovesPerPlayer(other.maxMovesPerPlayer),
+      nextPlayerId(other.nextPlayerId.load()) {
+  std::lock_guard<std::mutex> lock(other.mutex);
+  commands = other.commands;
+  pendingMoves = other.pendingMoves;
+}
+
+int CommandBuffer::reservePlayerId() { return nextPlayerId.fetch_add(1); }
+
+void CommandBuffer::submit(CommandType type, int playerId,
+                           const Point &direction) {
+  static auto &submitted = MetricsRegistry::getInstance().counter(
+      "md_player_commands_total", "Player commands submitted");
+  static auto &dropped = MetricsRegistry::getInstance().counter(
+      "md_player_commands_dropped_total",
+      "Player moves dropped because too many were pending");
+  submitted.increment();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (type == CommandType::MOVE && maxMovesPerPlayer > 0 &&
+      pendingMoves[playerId]++ >= maxMovesPerPlayer) {
+    dropped.increment();
+    return;
+  }
+  commands.push_back({type, playerId, direction});
+}
+
+std::vector<PlayerCommand> CommandBuffer::take() {
+  std::vector<PlayerCommand> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    batch.swap(commands);
+    pendingMoves.clear();
+  }
+
+  // Round of every command within its player's own sequence
+  std::unordered_map<int, size_t> seen;
+  std::vector<std::pair<size_t, size_t>> order;
+  order.reserve(batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    order.emplace_back(seen[batch[i].playerId]++, i);
+  }
+  std::sort(order.begin(), order.end(), [&](const auto &a, const auto &b) {
+    if (a.first != b.first) {
+      return a.first < b.first;
+    }
+    return batch[a.second].playerId < batch[b.second].playerId;
+  });
+
+  std::vector<PlayerCommand> result;
+  result.reserve(batch.size());
+  for (const auto &[round, index] : order) {
+    result.push_back(batch[index]);
+  }
+  return result;
+}
+
+size_t CommandBuffer::pending() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return commands.size();
+}
@@ -0,0 +1,65 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include "utils/point.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+enum class CommandType : uint8_t { JOIN, MOVE, LEAVE };
+
+struct PlayerCommand {
+  CommandType type;
+  int playerId;
+  Point direction;
+};
+
+class CommandBuffer {
+  /**
+   * @brief Collects player commands between two simulation ticks.
+   * Input threads (the local keyboard, socket clients, bots) only append
+   * to the buffer, the simulation takes the whole batch once per tick and
+   * applies it on its own thread. Commands are optimistic: they are checked
+   * against the world only when applied, so two players moving into the
+   * same cell are resolved by the order of the batch instead of by a lock
+   * held while the input is produced.
+   * The batch is interleaved in rounds, the first command of every player
+   * before the second command of any player, with players in id order
+   * inside a round. The result does not depend on thread timing and a
+   * player flooding the buffer cannot delay the others.
+   * Moves beyond maxMovesPerPlayer per player and batch are dropped, so
+   * keys sent while the simulation is not ticking do not pile up and
+   * play out as one burst when it resumes.
+   */
+public:
+  static constexpr int localPlayerId = 0;
+
+  // 0 keeps every move
+  explicit CommandBuffer(size_t maxMovesPerPlayer = 0);
+  // Copies the pending commands, e.g. when the world is forked
+  CommandBuffer(const CommandBuffer &other);
+  CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+  // Ids for remote players and bots, never localPlayerId
+  int reservePlayerId();
+
+  void submit(CommandType type, int playerId,
+              const Point &direction = Point(0, 0));
+
+  // Removes and returns every command submitted so far
+  std::vector<PlayerCommand> take();
+
+  size_t pending() const;
+
+private:
+  mutable std::mutex mutex;
+  std::vector<PlayerCommand> commands;
+  size_t maxMovesPerPlayer;
+  std::unordered_map<int, size_t> pendingMoves; // by player id
+  std::atomic<int> nextPlayerId{localPlayerId + 1};
+};
+
+#endif // COMMAND_BUFFER_H
@@ -0,0 +1,151 @@
+#include "crowd_steering.h"
+#include "utils/metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Closest of the eight directions, (0, 0) for a null vector. A component
+// counts once it is at least tan(22.5 degrees) of the other one
+Point quantize(double x, double y) {
+  const double tan22 = 0.41421356;
+  auto sign = [](double value) { return value > 0 ? 1 : value < 0 ? -1 : 0; };
+  return Point(std::abs(x) >= tan22 * std::abs(y) ? sign(x) : 0,
+               std::abs(y) >= tan22 * std::abs(x) ? sign(y) : 0);
+}
+} // namespace
+
+CrowdSteering::CrowdSteering(double _separationWeight,
+                             double _alignmentWeight)
+    : separationWeight(_separationWeight),
+      alignmentWeight(_alignmentWeight) {}
+
+void CrowdSteering::plan(const Map &map, const MonsterList &monsters) {
+  static auto &waits = MetricsRegistry::getInstance().counter(
+      "md_crowd_waits_total", "Monster steps held back to queue in crowds");
+  static auto &steeredSteps = MetricsRegistry::getInstance().counter(
+      "md_crowd_steered_total", "Monster steps changed to avoid crowding");
+
+  auto count = monsters.size();
+  positions.resize(count);
+  wanted.resize(count);
+  steps.resize(count);
+  waiting.assign(count, 0);
+  alive.assign(count, 0);
+  steerable.assign(count, 0);
+  for (size_t i = 0; i < count; ++i) {
+    const auto &monster = monsters[i];
+    positions[i] = monster->position;
+    if (!monster->isAlive()) {
+      wanted[i] = Point(0, 0);
+      continue;
+    }
+    alive[i] = 1;
+    // Asked before the step, which may take the last cell of the path
+    bool onPath = monster->followsPath();
+    wanted[i] = monster->getVelocity();
+    steerable[i] = !onPath && !(wanted[i] == Point(0, 0));
+  }
+  steps = wanted;
+
+  // Counting sort of the living monsters by bucket
+  const int columns = (map.getWidth() + cellSize - 1) / cellSize;
+  const int rows = (map.getHeight() + cellSize - 1) / cellSize;
+  auto bucketOf = [&](const Point &point) {
+    auto column = std::clamp(point.x / cellSize, 0, columns - 1);
+    auto row = std::clamp(point.y / cellSize, 0, rows - 1);
+    return static_cast<size_t>(row) * columns + column;
+  };
+  bucketStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    if (alive[i]) {
+      ++bucketStart[bucketOf(positions[i]) + 1];
+    }
+  }
+  for (size_t bucket = 1; bucket < bucketStart.size(); ++bucket) {
+    bucketStart[bucket] += bucketStart[bucket - 1];
+  }
+  order.resize(bucketStart.back());
+  sortedPositions.resize(order.size());
+  sortedWanted.resize(order.size());
+  sortedSteerable.resize(order.size());
+  {
+    auto next = bucketStart;
+    for (size_t i = 0; i < count; ++i) {
+      if (alive[i]) {
+        auto entry = next[bucketOf(positions[i])]++;
+        order[entry] = static_cast<uint32_t>(i);
+        sortedPositions[entry] = positions[i];
+        sortedWanted[entry] = wanted[i];
+        sortedSteerable[entry] = steerable[i];
+      }
+    }
+  }
+
+  uint64_t waitCount = 0;
+  uint64_t steeredCount = 0;
+
+  // Going through the monsters bucket by bucket keeps the buckets scanned
+  // for one monster in cache for the next
+  for (size_t current = 0; current < order.size(); ++current) {
+    if (!sortedSteerable[current]) {
+      continue;
+    }
+    const auto &position = sortedPositions[current];
+    const auto &step = sortedWanted[current];
+    auto target = position + step;
+    double separationX = 0, separationY = 0;
+    double alignmentX = 0, alignmentY = 0;
+    int neighbours = 0;
+    bool queued = false;
+
+    // Buckets overlapped by the square of radius around the monster
+    auto left = std::max(position.x - radius, 0) / cellSize;
+    auto top = std::max(position.y - radius, 0) / cellSize;
+    auto right = std::min((position.x + radius) / cellSize, columns - 1);
+    auto bottom = std::min((position.y + radius) / cellSize, rows - 1);
+    for (auto row = top; row <= bottom; ++row) {
+      for (auto column = left; column <= right; ++column) {
+        auto bucket = static_cast<size_t>(row) * columns + column;
+        for (auto entry = bucketStart[bucket];
+             entry < bucketStart[bucket + 1]; ++entry) {
+          const auto &other = sortedPositions[entry];
+          const auto &otherWanted = sortedWanted[entry];
+          int dx = position.x - other.x;
+          int dy = position.y - other.y;
+          int squared = dx * dx + dy * dy;
+          if (squared == 0 || squared > radius * radius) {
+            continue;
+          }
+          if (other == target && otherWanted == step) {
+            queued = true;
+          }
+          separationX += static_cast<double>(dx) / squared;
+          separationY += static_cast<double>(dy) / squared;
+          alignmentX += otherWanted.x;
+          alignmentY += otherWanted.y;
+          ++neighbours;
+        }
+      }
+    }
+
+    if (queued) {
+      waiting[order[current]] = 1;
+      ++waitCount;
+      continue;
+    }
+    if (neighbours == 0) {
+      continue;
+    }
+    auto steered = quantize(step.x + separationWeight * separationX +
+                                alignmentWeight * alignmentX / neighbours,
+                            step.y + separationWeight * separationY +
+                                alignmentWeight * alignmentY / neighbours);
+    if (!(steered == Point(0, 0)) && !(steered == step) &&
+        map.isPositionFree(position + steered)) {
+      steps[order[current]] = steered;
+      ++steeredCount;
+    }
+  }
+  waits.increment(waitCount);
+  steeredSteps.increment(steeredCount);
+}
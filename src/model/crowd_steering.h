@@ -0,0 +1,63 @@
+#ifndef CROWD_STEERING_H
+#define CROWD_STEERING_H
+
+#include "entities/monster.h"
+#include "map.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CrowdSteering {
+  /**
+   * @brief Steers wandering monsters around each other, a tick at a time.
+   * plan() asks every monster for the step it wants to make, then puts the
+   * monsters in a spatial hash (buckets of cellSize cells, rebuilt by a
+   * counting sort every tick) and adjusts each step with the neighbours
+   * within radius cells:
+   * - separation pushes a monster away from the ones closest to it,
+   * - alignment turns it towards the average step of its neighbours,
+   * - a monster whose next cell holds a neighbour about to move on in the
+   *   same direction queues behind it for the tick instead of turning
+   *   around, which is what keeps a corridor flowing.
+   * Adjusted steps that run into something keep the step the monster
+   * wanted. Monsters following a path or standing still are left alone.
+   * All steps are planned from where the monsters stand at the start of
+   * the tick, so the plan does not depend on the order they move in.
+   */
+public:
+  static constexpr int cellSize = 4;
+  static constexpr int radius = 2;
+
+  explicit CrowdSteering(double separationWeight = 1.0,
+                         double alignmentWeight = 0.5);
+
+  void plan(const Map &map, const MonsterList &monsters);
+
+  // Planned step of monsters[index], as of the last plan()
+  Point stepOf(size_t index) const { return steps[index]; }
+  bool waits(size_t index) const { return waiting[index] != 0; }
+
+  double getSeparationWeight() const { return separationWeight; }
+  double getAlignmentWeight() const { return alignmentWeight; }
+
+private:
+  double separationWeight;
+  double alignmentWeight;
+
+  // Reused between ticks to avoid reallocating every tick
+  std::vector<Point> positions;
+  std::vector<Point> wanted;
+  std::vector<Point> steps;
+  std::vector<uint8_t> waiting;
+  std::vector<uint8_t> alive;
+  std::vector<uint8_t> steerable;
+  std::vector<uint32_t> bucketStart; // first entry of every bucket in order
+  // Monsters sorted by bucket, with what the scan reads of them copied in
+  // the same order, so it does not jump around the monster list
+  std::vector<uint32_t> order;
+  std::vector<Point> sortedPositions;
+  std::vector<Point> sortedWanted;
+  std::vector<uint8_t> sortedSteerable;
+};
+
+#endif // CROWD_STEERING_H
@@ -1,4 +1,5 @@
 #include "entity.h"
+#include "utils/zobrist_hash.h"
 
 Entity::Entity() {}
 
@@ -6,3 +7,10 @@ Entity::Entity(const Point &_position, CellType _cellType)
     : position(_position), cellType(_cellType) {}
 
 Entity::~Entity() {}
+
+uint64_t Entity::stateKey() const {
+  auto key = ZobristHash::combine(ZobristHash::entitySeed,
+                                  static_cast<uint64_t>(cellType));
+  key = ZobristHash::combine(key, static_cast<uint32_t>(position.x));
+  return ZobristHash::combine(key, static_cast<uint32_t>(position.y));
+}
@@ -3,6 +3,7 @@
 
 #include "utils/game_settings.h"
 #include "utils/point.h"
+#include <cstdint>
 #include <string>
 
 class Entity {
@@ -15,6 +16,8 @@ public:
   // Other member functions
   virtual void move(const Point &destination) = 0;
   virtual std::string toString() const = 0;
+  // Zobrist key of the entity in its current state
+  virtual uint64_t stateKey() const;
 
   // data
   Point position;
@@ -1,8 +1,8 @@
 #include "monster.h"
 #include "algorithms/a_star.h"
+#include "utils/event_logger.h"
 #include "utils/global_config.h"
 #include <chrono>
-#include <future>
 #include <random>
 
 std::unordered_map<CellType, int> monsterExpMap = {{CellType::GOBLIN, 100},
@@ -10,25 +10,25 @@ std::unordered_map<CellType, int> monsterExpMap = {{CellType::GOBLIN, 100},
                                                    {CellType::DRAGON, 300},
                                                    {CellType::TROLL, 400}};
 
-std::mt19937 generateSeededRNG() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  return gen;
-}
-
 Monster::Monster(CellType cellType, int _health, int _attack)
-    : MovableEntity(cellType, _health, _attack) {}
+    : MovableEntity(cellType, _health, _attack), rng(std::random_device{}()),
+      fullHealth(_health) {}
 
 void Monster::randomizeVelocity() {
-  static std::mt19937 gen = generateSeededRNG();
   std::uniform_int_distribution<> distrib(-1, 1);
 
   do {
-    velocity.x = distrib(gen);
-    velocity.y = distrib(gen);
+    velocity.x = distrib(rng);
+    velocity.y = distrib(rng);
   } while (velocity.x == 0 && velocity.y == 0);
 }
 
+void Monster::revive(const Point &_position) {
+  health = fullHealth;
+  position = _position;
+  randomizeVelocity();
+}
+
 Goblin::Goblin()
     : Monster(CellType::GOBLIN,
               GlobalConfig::getInstance().getConfig<int>("GoblinHealth"),
@@ -40,17 +40,25 @@ void Goblin::move(const Point &destination) {
 }
 
 std::string Goblin::toString() const { return "Goblin"; }
-Orc::Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
+
+std::shared_ptr<Monster> Goblin::clone(const MonsterWorld &) const {
+  return makeTracked<MemoryTag::ENTITIES, Goblin>(*this);
+}
+
+Orc::Orc(std::shared_ptr<Map> _map, PlayerLocator _nearestPlayer,
+         std::shared_ptr<PathScheduler> _scheduler)
     : Monster(CellType::ORC,
               GlobalConfig::getInstance().getConfig<int>("OrcHealth"),
               GlobalConfig::getInstance().getConfig<int>("OrcDamage")),
-      map(std::move(_map)), player(std::move(_player)) {}
+      map(std::move(_map)), nearestPlayer(std::move(_nearestPlayer)),
+      scheduler(std::move(_scheduler)) {}
 
 void Orc::move(const Point &destination) {
   std::lock_guard<std::mutex> lock(mutex);
   MovableEntity::move(destination);
 
-  if (position.distance(player->position) < 5) {
+  auto player = nearestPlayer(position);
+  if (player && position.distance(player->position) < 5) {
     randomizeVelocity();
   }
 }
@@ -66,10 +74,30 @@ Point Orc::getVelocity() {
   return velocity;
 }
 
+bool Orc::followsPath() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return !path.empty();
+}
+
 std::string Orc::toString() const { return "Orc"; }
 
+// A search still running belongs to the scheduler of the original world,
+// the copy asks its own scheduler again
+Orc::Orc(const Orc &other, const MonsterWorld &world)
+    : Monster(other), map(world.map), nearestPlayer(world.nearestPlayer),
+      scheduler(world.scheduler), path(other.path), life(other.life) {}
+
+std::shared_ptr<Monster> Orc::clone(const MonsterWorld &world) const {
+  return makeTracked<MemoryTag::ENTITIES, Orc>(*this, world);
+}
+
 void Orc::randomizeVelocity() {
-  if (position.distance(player->position) > 10) {
+  if (pathRequested) {
+    return;
+  }
+  auto player = nearestPlayer(position);
+  if (!player || position.distance(player->position) > 10 ||
+      !map->isReachable(position, player->position)) {
     return;
   }
 
@@ -77,21 +105,40 @@ void Orc::randomizeVelocity() {
     return cell == CellType::EMPTY || cell == CellType::PLAYER;
   };
 
-  auto futurePath =
-      std::async(std::launch::async, [&, playerPosition = player->position]() {
-        AStar<CellType> aStar(map->grid, position, playerPosition, isNavigable);
-        return aStar.getPath();
+  // The search runs over the next ticks, the orc may be gone by then
+  pathRequested = true;
+  scheduler->request(
+      map, position, player->position, isNavigable,
+      [self = weak_from_this(), askedIn = life](std::deque<Point> newPath) {
+        if (auto orc = self.lock()) {
+          orc->receivePath(std::move(newPath), askedIn);
+        }
       });
+}
 
-  try {
-    path = futurePath.get();
-    if (!path.empty()) {
-      path.pop_front();
-    }
-  } catch (const std::system_error &e) {
-    // Handle the error
-    std::cerr << "Error occurred: " << e.what() << '\n';
+void Orc::revive(const Point &_position) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    path.clear();
+    ++life;
+  }
+  Monster::revive(_position);
+}
+
+void Orc::receivePath(std::deque<Point> newPath, unsigned int askedIn) {
+  std::lock_guard<std::mutex> lock(mutex);
+  pathRequested = false;
+  if (askedIn != life) {
+    // Starts where the orc died
+    return;
   }
+  path = std::move(newPath);
+  if (!path.empty()) {
+    path.pop_front();
+  }
+  EventLogger::getInstance().log(EventType::PATH_COMPUTED,
+                                 static_cast<int32_t>(path.size()), position.x,
+                                 position.y);
 }
 
 Troll::Troll()
@@ -108,6 +155,10 @@ void Troll::move(const Point &destination) {
 
 std::string Troll::toString() const { return "Troll"; }
 
+std::shared_ptr<Monster> Troll::clone(const MonsterWorld &) const {
+  return makeTracked<MemoryTag::ENTITIES, Troll>(*this);
+}
+
 Dragon::Dragon()
     : Monster(CellType::DRAGON,
               GlobalConfig::getInstance().getConfig<int>("DragonHealth"),
@@ -124,3 +175,7 @@ void Dragon::randomizeVelocity() {
 }
 
 std::string Dragon::toString() const { return "Dragon"; }
+
+std::shared_ptr<Monster> Dragon::clone(const MonsterWorld &) const {
+  return makeTracked<MemoryTag::ENTITIES, Dragon>(*this);
+}
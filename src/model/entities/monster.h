@@ -2,43 +2,90 @@
 #define _MONSTER_H
 
 #include "model/map.h"
+#include "model/path_scheduler.h"
 #include "movable_entity.h"
 #include "player.h"
+#include "utils/memory_tracker.h"
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <unordered_map>
+#include <vector>
 
 extern std::unordered_map<CellType, int> monsterExpMap;
 
+// What monsters of one world share, handed to clone() when it is forked
+struct MonsterWorld {
+  std::shared_ptr<Map> map;
+  std::function<std::shared_ptr<Player>(const Point &)> nearestPlayer;
+  std::shared_ptr<PathScheduler> scheduler;
+};
+
 class Monster : public MovableEntity {
 
+protected:
+  // Each monster draws from its own generator, so monsters can be updated
+  // on different threads with reproducible results
+  std::minstd_rand rng;
+  int fullHealth;
+
 public:
   Monster(CellType cellType, int _health, int _attack);
   virtual void randomizeVelocity();
+  // Back at full health on position, for a dead monster taken up again
+  virtual void revive(const Point &position);
+  // Whether the next steps come from a path rather than from wandering
+  virtual bool followsPath() { return false; }
+  void seed(uint32_t value) { rng.seed(value); }
+  // Copy of the monster, random generator included, living in world
+  virtual std::shared_ptr<Monster> clone(const MonsterWorld &world) const = 0;
 };
 
+using MonsterList =
+    std::vector<std::shared_ptr<Monster>,
+                TrackingAllocator<std::shared_ptr<Monster>, MemoryTag::ENTITIES>>;
+
 class Goblin : public Monster {
 
 public:
   explicit Goblin();
   void move(const Point &destination) override;
   auto toString() const -> std::string override;
+  std::shared_ptr<Monster> clone(const MonsterWorld &world) const override;
 };
 
-class Orc : public Monster {
+class Orc : public Monster, public std::enable_shared_from_this<Orc> {
+
+public:
+  // Living player closest to a point, nullptr when there is none
+  using PlayerLocator = std::function<std::shared_ptr<Player>(const Point &)>;
 
+private:
   std::shared_ptr<Map> map;
-  std::shared_ptr<Player> player;
+  PlayerLocator nearestPlayer;
+  std::shared_ptr<PathScheduler> scheduler;
   std::deque<Point> path;
+  bool pathRequested = false;
+  unsigned int life = 0; // paths asked for in earlier lives are dropped
   std::mutex mutex;
 
+  void receivePath(std::deque<Point> newPath, unsigned int askedIn);
+
 public:
-  explicit Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> player);
+  explicit Orc(std::shared_ptr<Map> _map, PlayerLocator nearestPlayer,
+               std::shared_ptr<PathScheduler> scheduler);
+  // Copy of other living in world, see clone()
+  Orc(const Orc &other, const MonsterWorld &world);
   void move(const Point &destination);
   auto toString() const -> std::string override;
   void randomizeVelocity() override;
+  void revive(const Point &position) override;
+  bool followsPath() override;
   Point getVelocity() override;
+  std::shared_ptr<Monster> clone(const MonsterWorld &world) const override;
 };
 
 class Troll : public Monster {
@@ -47,6 +94,7 @@ public:
   explicit Troll();
   void move(const Point &destination);
   auto toString() const -> std::string override;
+  std::shared_ptr<Monster> clone(const MonsterWorld &world) const override;
 };
 
 class Dragon : public Monster {
@@ -56,6 +104,7 @@ public:
   void move(const Point &destination);
   void randomizeVelocity() override;
   auto toString() const -> std::string override;
+  std::shared_ptr<Monster> clone(const MonsterWorld &world) const override;
 };
 
 #endif
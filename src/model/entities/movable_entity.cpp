@@ -1,4 +1,5 @@
 #include "movable_entity.h"
+#include "utils/zobrist_hash.h"
 
 MovableEntity::MovableEntity(CellType _cellType, int _health, int _strength,
                              const Point &_position, const Point &_velocity)
@@ -19,3 +20,9 @@ void MovableEntity::takeDamage(int damage) {
 void MovableEntity::move(const Point &destination) { position = destination; }
 
 Point MovableEntity::getVelocity() { return velocity; }
+
+uint64_t MovableEntity::stateKey() const {
+  auto key = ZobristHash::combine(Entity::stateKey(),
+                                  static_cast<uint32_t>(health));
+  return ZobristHash::combine(key, static_cast<uint32_t>(strength));
+}
@@ -20,6 +20,7 @@ public:
   void takeDamage(int damage);
   virtual Point getVelocity();
   virtual void move(const Point &destination);
+  uint64_t stateKey() const override;
 
   // data
   int health;
@@ -1,12 +1,13 @@
 #include "player.h"
 #include "utils/global_config.h"
+#include "utils/zobrist_hash.h"
 #include <cmath>
 
-Player::Player()
+Player::Player(int id)
     : MovableEntity(CellType::PLAYER,
                     GlobalConfig::getInstance().getConfig<int>("PlayerHealth"),
                     GlobalConfig::getInstance().getConfig<int>("PlayerDamage")),
-      level(1), exp(0) {}
+      id(id), level(1), exp(0) {}
 
 Player::~Player() {}
 
@@ -48,4 +49,13 @@ void Player::heal(int _health) {
 
 void Player::increaseStrength(int _strength) { strength += _strength; }
 
-auto Player::toString() const -> std::string { return "Player"; }
+auto Player::toString() const -> std::string {
+  return id == 0 ? "Player" : "Player " + std::to_string(id);
+}
+
+uint64_t Player::stateKey() const {
+  auto key = ZobristHash::combine(MovableEntity::stateKey(),
+                                  static_cast<uint32_t>(id));
+  key = ZobristHash::combine(key, static_cast<uint32_t>(level));
+  return ZobristHash::combine(key, static_cast<uint32_t>(exp));
+}
@@ -2,13 +2,16 @@
 #define PLAYER_H
 
 #include "movable_entity.h"
+#include "utils/memory_tracker.h"
+#include <memory>
+#include <vector>
 
 class Player : public MovableEntity {
 private:
   bool isLevelUp() const;
 
 public:
-  Player();
+  explicit Player(int id = 0);
   ~Player();
 
   void addExperience(int _exp);
@@ -20,11 +23,17 @@ public:
   int expToNextLevel() const;
 
   std::string toString() const override;
+  uint64_t stateKey() const override;
   // void exploreTreasure(const Treasure &treasure);
 
   // data
+  int id; // 0 for the local player
   int level;
   int exp;
 };
 
+using PlayerList =
+    std::vector<std::shared_ptr<Player>,
+                TrackingAllocator<std::shared_ptr<Player>, MemoryTag::ENTITIES>>;
+
 #endif
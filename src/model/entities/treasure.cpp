@@ -1,9 +1,11 @@
 #include "treasure.h"
 #include "utils/game_settings.h"
+#include "utils/zobrist_hash.h"
 #include <random>
 
 Treasure::Treasure()
-    : Entity(), value(GlobalConfig::getInstance().getConfig<int>("BonusValue")),
+    : Entity(Point(-1, -1), CellType::TREASURE),
+      value(GlobalConfig::getInstance().getConfig<int>("BonusValue")),
       expirationCounter(GlobalConfig::getInstance().getConfig<int>(
           "BonusExpirationCounter")) {
   std::random_device rd;
@@ -24,14 +26,12 @@ Treasure::Treasure()
   default:
     bonusType = BonusType::Experience;
   }
-
-  position = Point(-1, -1);
 }
 
 Treasure::Treasure(const Point &_position, int _value, BonusType _bonusType,
                    int _expirationCounter)
-    : Entity(_position, CellType::EMPTY), value(_value), bonusType(_bonusType),
-      expirationCounter(_expirationCounter) {}
+    : Entity(_position, CellType::TREASURE), value(_value),
+      bonusType(_bonusType), expirationCounter(_expirationCounter) {}
 
 void Treasure::move(const Point &destination) {
 
@@ -64,3 +64,9 @@ std::string Treasure::toString() const {
     return "Treasure";
   }
 }
+
+uint64_t Treasure::stateKey() const {
+  auto key = ZobristHash::combine(Entity::stateKey(),
+                                  static_cast<uint32_t>(value));
+  return ZobristHash::combine(key, static_cast<uint64_t>(bonusType));
+}
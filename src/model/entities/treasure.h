@@ -3,6 +3,9 @@
 
 #include "entity.h"
 #include "utils/global_config.h"
+#include "utils/memory_tracker.h"
+#include <memory>
+#include <unordered_map>
 
 enum class BonusType { Experience, Health, Strength };
 
@@ -28,6 +31,12 @@ public:
 
   void move(const Point &destination) override;
   std::string toString() const override;
+  uint64_t stateKey() const override;
 };
 
+using TreasureMap = std::unordered_map<
+    Point, std::shared_ptr<Treasure>, std::hash<Point>, std::equal_to<Point>,
+    TrackingAllocator<std::pair<const Point, std::shared_ptr<Treasure>>,
+                      MemoryTag::ENTITIES>>;
+
 #endif
@@ -0,0 +1,88 @@
+#include "floor_stack.h"
+#include <chrono>
+
+FloorStack::FloorStack(const FloorStack &other) {
+  floors.reserve(other.floors.size());
+  for (const auto &entry : other.floors) {
+    floors.push_back({entry.stored, {}});
+  }
+}
+
+void FloorStack::store(size_t index, const Floor &floor) {
+  // Orcs keep a pointer to their map, the frozen copies get none so the
+  // full grid is freed once it is packed
+  auto stored = std::make_shared<StoredFloor>();
+  stored->monsters.reserve(floor.monsters.size());
+  for (const auto &monster : floor.monsters) {
+    stored->monsters.push_back(monster->clone(MonsterWorld{}));
+  }
+  for (const auto &[position, treasure] : floor.treasures) {
+    stored->treasures.emplace(
+        position, makeTracked<MemoryTag::ENTITIES, Treasure>(*treasure));
+  }
+
+  Entry entry;
+  entry.stored =
+      std::async(std::launch::async,
+                 [stored, map = floor.map]() mutable
+                 -> std::shared_ptr<const StoredFloor> {
+                   stored->map = map->pack();
+                   // Distances, areas and rooms take four bytes a cell
+                   // each, many times the packed cells. Unpacking
+                   // rebuilds them.
+                   stored->map.dropDerived();
+                   map.reset();
+                   return stored;
+                 })
+          .share();
+
+  if (index == floors.size()) {
+    floors.push_back(std::move(entry));
+  } else {
+    floors.at(index) = std::move(entry);
+  }
+}
+
+FloorStack::Floor FloorStack::load(size_t index, MonsterWorld world) {
+  auto &entry = floors.at(index);
+  auto stored = entry.stored.get();
+  world.map = entry.unpacked.valid() ? entry.unpacked.get()
+                                     : std::make_shared<Map>(stored->map);
+  entry.unpacked = {};
+
+  Floor floor{world.map};
+  floor.monsters.reserve(stored->monsters.size());
+  for (const auto &monster : stored->monsters) {
+    floor.monsters.push_back(monster->clone(world));
+  }
+  for (const auto &[position, treasure] : stored->treasures) {
+    floor.treasures.emplace(
+        position, makeTracked<MemoryTag::ENTITIES, Treasure>(*treasure));
+  }
+  return floor;
+}
+
+void FloorStack::prefetch(size_t index) {
+  if (index >= floors.size() || floors[index].unpacked.valid()) {
+    return;
+  }
+  floors[index].unpacked =
+      std::async(std::launch::async,
+                 [stored = floors[index].stored] {
+                   return std::make_shared<Map>(stored.get()->map);
+                 })
+          .share();
+}
+
+void FloorStack::clear() { floors.clear(); }
+
+size_t FloorStack::packedBytes() const {
+  size_t bytes = 0;
+  for (const auto &entry : floors) {
+    if (entry.stored.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      bytes += entry.stored.get()->map.residentBytes();
+    }
+  }
+  return bytes;
+}
@@ -0,0 +1,64 @@
+#ifndef FLOOR_STACK_H
+#define FLOOR_STACK_H
+
+#include "entities/monster.h"
+#include "entities/treasure.h"
+#include "map.h"
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+class FloorStack {
+  /**
+   * @brief Dungeon floors as the players last left them, top floor first.
+   * A floor that is left is packed on a background thread: the grid is
+   * run-length encoded, the data derived from the cells is dropped and the
+   * entities are frozen as copies that do not refer to the full grid, so
+   * only the current floor takes the memory of a playable map. Taking stairs back unpacks the floor again, and
+   * prefetch() does that in the background while the players walk towards
+   * the stairs, so the change itself does not wait for it.
+   * Stored floors never change, copies of the stack share them.
+   */
+public:
+  struct Floor {
+    std::shared_ptr<Map> map;
+    MonsterList monsters;
+    TreasureMap treasures;
+  };
+
+  FloorStack() = default;
+  // Shares the stored floors but not the prefetched maps
+  FloorStack(const FloorStack &other);
+  FloorStack &operator=(const FloorStack &) = delete;
+
+  size_t size() const { return floors.size(); }
+
+  // Packs floor as number index, index == size() adds a floor at the bottom
+  void store(size_t index, const Floor &floor);
+  // Floor index as it was stored, its monsters living in world (the map of
+  // world is replaced by the unpacked one)
+  Floor load(size_t index, MonsterWorld world);
+  // Starts unpacking floor index in the background, if it is stored
+  void prefetch(size_t index);
+  void clear();
+
+  // Bytes kept by the packed maps, for floors that finished packing
+  size_t packedBytes() const;
+
+private:
+  struct StoredFloor {
+    PackedMap map;
+    MonsterList monsters;
+    TreasureMap treasures;
+  };
+
+  struct Entry {
+    std::shared_future<std::shared_ptr<const StoredFloor>> stored;
+    std::shared_future<std::shared_ptr<Map>> unpacked; // set by prefetch()
+  };
+
+  std::vector<Entry> floors;
+};
+
+#endif // FLOOR_STACK_H
@@ -0,0 +1,244 @@
+#include "level_cache.h"
+#include "utils/global_config.h"
+#include "utils/metrics.h"
+#include "utils/zobrist_hash.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+constexpr char levelFileMagic[8] = {'M', 'D', 'L', 'E', 'V', 'E', 'L', '\0'};
+constexpr uint32_t levelFileVersion = 1;
+
+struct LevelFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t seed;
+  uint32_t width;
+  uint32_t height;
+  uint32_t algorithm;
+  int32_t start[2];
+  int32_t end[2];
+  uint32_t roomCount;
+  uint64_t hash;
+  // Packed cells, followed by width * height distances and by the rooms,
+  // four int32_t each
+  uint64_t cellBytes;
+};
+} // namespace
+
+uint64_t LevelKey::digest() const {
+  auto key = ZobristHash::combine(0x4C6576656C4B6579ull, seed);
+  key = ZobristHash::combine(key, width);
+  key = ZobristHash::combine(key, height);
+  return ZobristHash::combine(key, static_cast<uint64_t>(algorithm));
+}
+
+bool LevelKey::operator==(const LevelKey &other) const {
+  return seed == other.seed && width == other.width &&
+         height == other.height && algorithm == other.algorithm;
+}
+
+LevelCache::LevelCache(size_t _capacity, std::string _directory)
+    : capacity(_capacity), directory(std::move(_directory)) {}
+
+LevelCache &LevelCache::getInstance() {
+  static LevelCache instance(
+      GlobalConfig::getInstance().getConfig<int>("LevelCacheSize", 16),
+      GlobalConfig::getInstance().getConfig<std::string>("LevelCacheDir",
+                                                         ""));
+  return instance;
+}
+
+std::shared_ptr<const PackedMap> LevelCache::get(const LevelKey &key) {
+  static auto &memoryHits = MetricsRegistry::getInstance().counter(
+      "md_level_cache_memory_hits_total", "Levels found in memory");
+  static auto &diskHits = MetricsRegistry::getInstance().counter(
+      "md_level_cache_disk_hits_total", "Levels read from the cache directory");
+  static auto &generated = MetricsRegistry::getInstance().counter(
+      "md_levels_generated_total", "Levels generated on a cache miss");
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(key.digest());
+    if (found != entries.end() && found->second->first == key) {
+      recent.splice(recent.begin(), recent, found->second);
+      memoryHits.increment();
+      return found->second->second;
+    }
+  }
+
+  // Reading or generating happens outside the lock, two callers missing
+  // the same level at once both build it and the results are equal
+  auto level = read(key);
+  if (level) {
+    diskHits.increment();
+  } else {
+    Map map(key.width, key.height, GridLayout::ROW_MAJOR, GridStorage::BYTE);
+    map.loadLevel(key.seed, key.algorithm);
+    level = std::make_shared<const PackedMap>(map.pack());
+    generated.increment();
+    write(key, *level);
+  }
+  remember(key, level);
+  return level;
+}
+
+void LevelCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  recent.clear();
+}
+
+size_t LevelCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return recent.size();
+}
+
+std::string LevelCache::pathOf(const LevelKey &key) const {
+  std::ostringstream path;
+  path << directory << "/" << std::hex << std::setw(16) << std::setfill('0')
+       << key.digest() << ".level";
+  return path.str();
+}
+
+void LevelCache::remember(const LevelKey &key,
+                          std::shared_ptr<const PackedMap> level) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (capacity == 0) {
+    return;
+  }
+  auto found = entries.find(key.digest());
+  if (found != entries.end()) {
+    recent.erase(found->second);
+    entries.erase(found);
+  }
+  recent.emplace_front(key, std::move(level));
+  entries[key.digest()] = recent.begin();
+  while (recent.size() > capacity) {
+    entries.erase(recent.back().first.digest());
+    recent.pop_back();
+  }
+}
+
+std::shared_ptr<const PackedMap> LevelCache::read(const LevelKey &key) const {
+  if (directory.empty()) {
+    return nullptr;
+  }
+  auto file = std::fopen(pathOf(key).c_str(), "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  LevelFileHeader header{};
+  auto level = std::make_shared<PackedMap>();
+  auto cellCount = static_cast<size_t>(key.width) * key.height;
+  auto distances = std::make_shared<std::vector<uint32_t>>(cellCount);
+  bool valid =
+      std::fread(&header, sizeof(header), 1, file) == 1 &&
+      std::memcmp(header.magic, levelFileMagic, sizeof(header.magic)) == 0 &&
+      header.version == levelFileVersion && header.seed == key.seed &&
+      header.width == key.width && header.height == key.height &&
+      header.algorithm == static_cast<uint32_t>(key.algorithm) &&
+      header.cellBytes <= cellCount && header.roomCount <= cellCount;
+  if (valid) {
+    level->cells.resize(header.cellBytes);
+    valid = std::fread(level->cells.data(), 1, level->cells.size(), file) ==
+                level->cells.size() &&
+            std::fread(distances->data(), sizeof(uint32_t), cellCount,
+                       file) == cellCount;
+  }
+  std::vector<Room> rooms(valid ? header.roomCount : 0);
+  for (auto &room : rooms) {
+    int32_t area[4] = {};
+    valid = valid && std::fread(area, sizeof(area), 1, file) == 1;
+    room = {area[0], area[1], area[2], area[3]};
+  }
+  std::fclose(file);
+
+  // The runs have to cover the grid exactly, or unpacking would write
+  // outside of it
+  size_t covered = 0;
+  for (auto run : level->cells) {
+    covered += (run & 0x0F) + 1;
+  }
+  if (!valid || covered != cellCount) {
+    return nullptr;
+  }
+
+  level->width = key.width;
+  level->height = key.height;
+  level->start = {header.start[0], header.start[1]};
+  level->end = {header.end[0], header.end[1]};
+  level->hash = header.hash;
+  level->exitDistances = std::move(distances);
+  // The areas and the graph are rebuilt rather than stored, they follow
+  // from the cells and the rooms
+  Map map(*level);
+  level->components = map.getComponents();
+  if (!rooms.empty()) {
+    level->roomGraph = std::make_shared<const RoomGraph>(
+        key.width, key.height,
+        [&map](const Point &point) {
+          return map.getCellType(point) == CellType::WALL;
+        },
+        std::move(rooms));
+  }
+  return level;
+}
+
+void LevelCache::write(const LevelKey &key, const PackedMap &level) const {
+  if (directory.empty() || !level.exitDistances) {
+    return;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  LevelFileHeader header{};
+  std::memcpy(header.magic, levelFileMagic, sizeof(header.magic));
+  header.version = levelFileVersion;
+  header.seed = key.seed;
+  header.width = key.width;
+  header.height = key.height;
+  header.algorithm = static_cast<uint32_t>(key.algorithm);
+  header.start[0] = level.start.x;
+  header.start[1] = level.start.y;
+  header.end[0] = level.end.x;
+  header.end[1] = level.end.y;
+  header.hash = level.hash;
+  header.cellBytes = level.cells.size();
+  if (level.roomGraph) {
+    header.roomCount =
+        static_cast<uint32_t>(level.roomGraph->getRooms().size());
+  }
+
+  // Written next to the target and renamed, so a reader never sees a
+  // partially written level
+  auto path = pathOf(key);
+  auto temporaryPath = path + ".tmp";
+  auto file = std::fopen(temporaryPath.c_str(), "wb");
+  if (!file) {
+    return;
+  }
+  bool written =
+      std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+      std::fwrite(level.cells.data(), 1, level.cells.size(), file) ==
+          level.cells.size() &&
+      std::fwrite(level.exitDistances->data(), sizeof(uint32_t),
+                  level.exitDistances->size(),
+                  file) == level.exitDistances->size();
+  if (level.roomGraph) {
+    for (const auto &room : level.roomGraph->getRooms()) {
+      int32_t area[4] = {room.x, room.y, room.width, room.height};
+      written = written && std::fwrite(area, sizeof(area), 1, file) == 1;
+    }
+  }
+  written = std::fclose(file) == 0 && written;
+  if (written) {
+    std::rename(temporaryPath.c_str(), path.c_str());
+  } else {
+    std::remove(temporaryPath.c_str());
+  }
+}
@@ -0,0 +1,68 @@
+#ifndef LEVEL_CACHE_H
+#define LEVEL_CACHE_H
+
+#include "map.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Everything a generated level depends on
+struct LevelKey {
+  unsigned int seed = 0;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  MazeGeneratorAlgorithm algorithm = MazeGeneratorAlgorithm::DepthFirstSearch;
+
+  // Content address of the level, also names its file on disk
+  uint64_t digest() const;
+  bool operator==(const LevelKey &other) const;
+};
+
+class LevelCache {
+  /**
+   * @brief Generated levels by seed, size and algorithm.
+   * A level is generated once, packed together with its exit distances,
+   * and kept in memory for the most recently used levels. With a directory
+   * set, levels are also written there as one file per level, named by the
+   * digest of their key, so later runs with the same seeds (benchmarks,
+   * replays, servers restarting) read them instead of generating them.
+   * Files are written next to their name and renamed, and read back only
+   * when their header matches the key, so stale or partial files are
+   * regenerated rather than trusted.
+   */
+public:
+  explicit LevelCache(size_t capacity = 16, std::string directory = "");
+
+  // Sized by LevelCacheSize, on disk in LevelCacheDir when that is set
+  static LevelCache &getInstance();
+
+  // The level for key, from memory, from disk or freshly generated
+  std::shared_ptr<const PackedMap> get(const LevelKey &key);
+  // Forgets the levels in memory, files on disk stay
+  void clear();
+
+  size_t size() const;
+  size_t getCapacity() const { return capacity; }
+  const std::string &getDirectory() const { return directory; }
+  std::string pathOf(const LevelKey &key) const;
+
+private:
+  using Entry = std::pair<LevelKey, std::shared_ptr<const PackedMap>>;
+
+  size_t capacity;
+  std::string directory;
+  std::list<Entry> recent; // most recently used first
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+  mutable std::mutex mutex;
+
+  std::shared_ptr<const PackedMap> read(const LevelKey &key) const;
+  void write(const LevelKey &key, const PackedMap &level) const;
+  void remember(const LevelKey &key, std::shared_ptr<const PackedMap> level);
+};
+
+#endif // LEVEL_CACHE_H
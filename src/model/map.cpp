@@ -1,35 +1,162 @@
 #include "map.h"
+#include "utils/global_config.h"
+#include "utils/metrics.h"
 #include <algorithm>
+#include <mutex>
+#include <queue>
 #include <random>
 
-Map::Map(unsigned int _width, unsigned int _height)
-    : width(_width), height(_height) {}
+Map::Map(unsigned int _width, unsigned int _height, GridLayout _layout,
+         GridStorage _storage)
+    : width(_width), height(_height), layout(_layout), storage(_storage) {}
 
-void Map::loadLevel() {
-  MazeGenerator generator(width, height,
-                          MazeGeneratorAlgorithm::DepthFirstSearch);
+Map::Map(const Map &other)
+    : grid(other.grid), hash(other.hash), rng(other.rng), width(other.width),
+      height(other.height), layout(other.layout), storage(other.storage),
+      start(other.start), end(other.end), exitDistances(other.exitDistances),
+      roomGraph(other.roomGraph), components(other.components),
+      lazyMaze(other.lazyMaze
+                   ? std::make_unique<LazyMazeGenerator>(*other.lazyMaze)
+                   : nullptr) {}
+
+Map::Map(const PackedMap &packed)
+    : Map(packed, packed.layout, packed.storage) {}
+
+Map::Map(const PackedMap &packed, GridLayout _layout, GridStorage _storage)
+    : grid(packed.width, packed.height, _layout, _storage),
+      width(packed.width), height(packed.height), layout(_layout),
+      storage(_storage), start(packed.start), end(packed.end),
+      exitDistances(packed.exitDistances), roomGraph(packed.roomGraph),
+      components(packed.components),
+      lazyMaze(packed.lazyMaze
+                   ? std::make_unique<LazyMazeGenerator>(*packed.lazyMaze)
+                   : nullptr) {
+  size_t cell = 0;
+  for (auto run : packed.cells) {
+    auto cellType = static_cast<CellType>(run >> 4);
+    for (int i = 0; i <= (run & 0x0F); ++i, ++cell) {
+      grid.set(cell % width, cell / width, cellType);
+    }
+  }
+  hash.reset(packed.hash);
+  if (lazyMaze) {
+    return;
+  }
+  if (!exitDistances) {
+    computeExitDistances();
+  }
+  if (!components) {
+    labelComponents();
+  }
+  if (!roomGraph && !packed.rooms.empty()) {
+    roomGraph = std::make_shared<const RoomGraph>(
+        width, height,
+        [this](const Point &point) {
+          return getCellType(point) == CellType::WALL;
+        },
+        packed.rooms);
+  }
+}
+
+void PackedMap::dropDerived() {
+  exitDistances.reset();
+  components.reset();
+  if (roomGraph) {
+    rooms = roomGraph->getRooms();
+    roomGraph.reset();
+  }
+}
+
+size_t PackedMap::residentBytes() const {
+  return cells.capacity() + rooms.capacity() * sizeof(Room) +
+         (lazyMaze ? lazyMaze->stateBytes() : 0);
+}
+
+void Map::loadLevel(unsigned int seed, MazeGeneratorAlgorithm algorithm) {
+  MazeGenerator generator(width, height, algorithm, seed);
   auto maze = generator.getMaze();
 
   // Convert maze to grid with CellType values
   grid = transformToGrid(maze);
+  journal.reset();
+  hash.reset(computeHash());
 
-  start = {generator.getStart().first, generator.getStart().second};
-  end = {generator.getEnd().first, generator.getEnd().second};
+  start = {static_cast<int>(generator.getStart().first),
+           static_cast<int>(generator.getStart().second)};
+  end = {static_cast<int>(generator.getEnd().first),
+         static_cast<int>(generator.getEnd().second)};
+  lazyMaze.reset();
+  computeExitDistances();
+  labelComponents();
+
+  roomGraph.reset();
+  if (!generator.getRooms().empty()) {
+    roomGraph = std::make_shared<const RoomGraph>(
+        width, height,
+        [this](const Point &point) {
+          return getCellType(point) == CellType::WALL;
+        },
+        generator.getRooms());
+  }
 }
 
-void Map::clear() {
-  for (auto &row : grid) {
-    std::fill(row.begin(), row.end(), CellType::EMPTY);
+void Map::loadLazyLevel(unsigned int seed) {
+  lazyMaze = std::make_unique<LazyMazeGenerator>(width, height, seed);
+  grid = Grid(width, height, layout, storage);
+  grid.fill(CellType::WALL);
+  journal.reset();
+  hash.reset(computeHash());
+
+  start = {static_cast<int>(lazyMaze->getStart().first),
+           static_cast<int>(lazyMaze->getStart().second)};
+  end = {static_cast<int>(lazyMaze->getEnd().first),
+         static_cast<int>(lazyMaze->getEnd().second)};
+  exitDistances.reset();
+  roomGraph.reset();
+  components.reset();
+}
+
+void Map::revealRows(unsigned int rows) {
+  static auto &rowsRevealed = MetricsRegistry::getInstance().counter(
+      "md_lazy_maze_rows_total", "Rows of lazily generated mazes carved");
+  if (!lazyMaze || rows <= lazyMaze->getGeneratedRows()) {
+    return;
+  }
+
+  // Passages are carved into the walls, anything placed there already
+  // (the stairs) stays
+  auto y = lazyMaze->getGeneratedRows();
+  for (const auto &row : lazyMaze->generateRows(rows)) {
+    for (unsigned int x = 0; x < row.size(); ++x) {
+      if (row[x] == ' ' && grid.get(x, y) == CellType::WALL) {
+        setCellType(Point(x, y), CellType::EMPTY);
+      }
+    }
+    ++y;
+    rowsRevealed.increment();
+  }
+
+  if (lazyMaze->isFinished()) {
+    lazyMaze.reset();
+    computeExitDistances();
+    labelComponents();
   }
 }
 
+void Map::clear() {
+  grid.fill(CellType::EMPTY);
+  journal.reset();
+  hash.reset();
+}
+
 bool Map::isPositionFree(const Point &point) const {
   return isValidPoint(point) && getCellType(point) == CellType::EMPTY;
 }
 
 Point Map::randomFreePosition() const {
   std::uniform_int_distribution<int> dist_x(0, width - 1);
-  std::uniform_int_distribution<int> dist_y(0, height - 1);
+  std::uniform_int_distribution<int> dist_y(
+      0, static_cast<int>(std::max(getRevealedRows(), 1u)) - 1);
 
   Point p;
   do {
@@ -39,6 +166,19 @@ Point Map::randomFreePosition() const {
   return p;
 }
 
+Point Map::randomFreePosition(const Point &reachableFrom) const {
+  Point p;
+  do {
+    p = randomFreePosition();
+  } while (!isReachable(reachableFrom, p));
+
+  return p;
+}
+
+bool Map::isReachable(const Point &from, const Point &to) const {
+  return !components || components->connected(from, to);
+}
+
 Point Map::getStart() const { return start; }
 
 Point Map::getEnd() const { return end; }
@@ -71,7 +211,13 @@ double Map::distance(const Point &point1, const Point &point2) const {
 
 void Map::setCellType(const Point &point, CellType symbol) {
   if (isValidPoint(point)) {
-    grid[point.y][point.x] = symbol;
+    auto previous = grid.get(point.x, point.y);
+    if (previous != symbol) {
+      grid.set(point.x, point.y, symbol);
+      journal.record(point, previous, symbol);
+      hash.toggle(ZobristHash::cellKey(point, previous) ^
+                  ZobristHash::cellKey(point, symbol));
+    }
   } else {
     //  throw std::out_of_range("Point is outside of the map's boundaries.");
   }
@@ -79,7 +225,7 @@ void Map::setCellType(const Point &point, CellType symbol) {
 
 CellType Map::getCellType(const Point &point) const {
   if (isValidPoint(point)) {
-    return grid[point.y][point.x];
+    return grid.get(point.x, point.y);
   } else {
     //  throw std::out_of_range("Point is outside of the map's boundaries.");
   }
@@ -89,18 +235,90 @@ bool Map::isValidPoint(const Point &point) const {
   return point.x >= 0 && point.x < width && point.y >= 0 && point.y < height;
 }
 
-std::vector<std::vector<CellType>>
-Map::transformToGrid(const std::vector<std::string> &maze) const {
-  std::vector<std::vector<CellType>> grid;
-  grid.reserve(maze.size());
+uint64_t Map::computeHash() const {
+  uint64_t fresh = 0;
+  for (unsigned int y = 0; y < grid.getHeight(); ++y) {
+    for (unsigned int x = 0; x < grid.getWidth(); ++x) {
+      fresh ^= ZobristHash::cellKey(Point(x, y), grid.get(x, y));
+    }
+  }
+  return fresh;
+}
+
+PackedMap Map::pack() const {
+  PackedMap packed{width, height, layout, storage, start, end, hash.get()};
+  packed.exitDistances = exitDistances;
+  packed.roomGraph = roomGraph;
+  packed.components = components;
+  if (lazyMaze) {
+    packed.lazyMaze = std::make_shared<const LazyMazeGenerator>(*lazyMaze);
+  }
+  for (unsigned int y = 0; y < height; ++y) {
+    for (unsigned int x = 0; x < width; ++x) {
+      auto cellType = static_cast<uint8_t>(grid.get(x, y)) << 4;
+      // Runs continue across rows, up to 16 cells per byte
+      if (!packed.cells.empty() && (packed.cells.back() & 0xF0) == cellType &&
+          (packed.cells.back() & 0x0F) < 0x0F) {
+        ++packed.cells.back();
+      } else {
+        packed.cells.push_back(cellType);
+      }
+    }
+  }
+  packed.cells.shrink_to_fit();
+  return packed;
+}
+
+uint32_t Map::exitDistance(const Point &point) const {
+  if (!exitDistances || !isValidPoint(point)) {
+    return unreachable;
+  }
+  return (*exitDistances)[point.y * width + point.x];
+}
+
+void Map::computeExitDistances() {
+  // Breadth-first from the exit, in the four directions players move in
+  auto distances = std::make_shared<std::vector<uint32_t>>(
+      static_cast<size_t>(width) * height, unreachable);
+  std::queue<Point> frontier;
+  if (isValidPoint(end) && getCellType(end) != CellType::WALL) {
+    (*distances)[end.y * width + end.x] = 0;
+    frontier.push(end);
+  }
+  const Point steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  while (!frontier.empty()) {
+    auto point = frontier.front();
+    frontier.pop();
+    auto distance = (*distances)[point.y * width + point.x] + 1;
+    for (const auto &step : steps) {
+      Point next{point.x + step.x, point.y + step.y};
+      if (isValidPoint(next) && getCellType(next) != CellType::WALL &&
+          (*distances)[next.y * width + next.x] == unreachable) {
+        (*distances)[next.y * width + next.x] = distance;
+        frontier.push(next);
+      }
+    }
+  }
+  exitDistances = std::move(distances);
+}
+
+void Map::labelComponents() {
+  // One pool for all the maps, levels are loaded from several threads
+  // (the floor prefetch) but the pool runs one job at a time
+  static std::mutex poolMutex;
+  static WorkerPool pool(
+      GlobalConfig::getInstance().getConfig<int>("SimulationThreads", 0));
+  std::lock_guard<std::mutex> lock(poolMutex);
+  components = std::make_shared<const ConnectedComponents>(grid, &pool);
+}
+
+Grid Map::transformToGrid(const std::vector<std::string> &maze) const {
+  Grid grid(maze.empty() ? 0 : maze[0].size(), maze.size(), layout, storage);
 
-  for (const auto &row : maze) {
-    std::vector<CellType> gridRow;
-    gridRow.reserve(row.size());
-    for (const auto &cell : row) {
-      gridRow.push_back(cell == '#' ? CellType::WALL : CellType::EMPTY);
+  for (size_t y = 0; y < maze.size(); ++y) {
+    for (size_t x = 0; x < maze[y].size(); ++x) {
+      grid.set(x, y, maze[y][x] == '#' ? CellType::WALL : CellType::EMPTY);
     }
-    grid.push_back(gridRow);
   }
 
   return grid;
@@ -1,22 +1,89 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include "algorithms/connected_components.h"
+#include "algorithms/lazy_maze_generator.h"
 #include "algorithms/maze_generator.h"
+#include "algorithms/room_graph.h"
+#include "map_journal.h"
 #include "utils/game_settings.h"
+#include "utils/grid.h"
 #include "utils/point.h"
+#include "utils/zobrist_hash.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
 #include <random>
 #include <vector>
+
+// A map nobody plays on, with the grid run-length encoded row by row: each
+// byte holds a cell type in the high and the run length minus one in the
+// low four bits. The exit distances, areas and room graph follow from the
+// cells, unpacking rebuilds the ones that were dropped.
+struct PackedMap {
+  unsigned int width = 0;
+  unsigned int height = 0;
+  GridLayout layout = GridLayout::ROW_MAJOR;
+  GridStorage storage = GridStorage::BYTE;
+  Point start;
+  Point end;
+  uint64_t hash = 0;
+  std::vector<uint8_t> cells;
+  std::shared_ptr<const std::vector<uint32_t>> exitDistances;
+  std::shared_ptr<const LazyMazeGenerator> lazyMaze; // rest of a lazy maze
+  std::shared_ptr<const RoomGraph> roomGraph;
+  std::shared_ptr<const ConnectedComponents> components;
+  std::vector<Room> rooms; // of a room graph dropped by dropDerived()
+
+  // Keeps only what cannot be rebuilt, about a byte per run of cells
+  void dropDerived();
+  // Bytes kept by the packed map itself, shared derived data aside
+  size_t residentBytes() const;
+};
+
 class Map {
 public:
-  std::vector<std::vector<CellType>> grid;
+  static constexpr uint32_t unreachable = UINT32_MAX;
+
+  Grid grid;
+  MapJournal journal; // every cell change made through setCellType
+  ZobristHash hash;   // of the grid, kept up to date by setCellType
 
-  Map(unsigned int width, unsigned int height);
-  void loadLevel();
+  Map(unsigned int width, unsigned int height,
+      GridLayout layout = parseGridLayout(DEFAULT_GRID_LAYOUT),
+      GridStorage storage = parseGridStorage(DEFAULT_GRID_STORAGE));
+  // Copies the cells but not the journal, the copy has no subscribers yet
+  Map(const Map &other);
+  // Unpacks a map stored with pack(), into the packed or another layout
+  explicit Map(const PackedMap &packed);
+  Map(const PackedMap &packed, GridLayout layout, GridStorage storage);
+  Map &operator=(const Map &) = delete;
+  // Generates a maze, the same seed and algorithm give the same level
+  void loadLevel(unsigned int seed = static_cast<unsigned int>(time(0)),
+                 MazeGeneratorAlgorithm algorithm =
+                     MazeGeneratorAlgorithm::DepthFirstSearch);
+  // Starts a maze of walls that revealRows() carves a few rows at a time,
+  // for maps too large to generate before anyone plays on them
+  void loadLazyLevel(unsigned int seed);
+  // Generates a lazy maze until its first rows exist, a no-op otherwise
+  void revealRows(unsigned int rows);
+  bool isFullyGenerated() const { return !lazyMaze; }
+  // Rows carved so far, every row once the map is fully generated
+  unsigned int getRevealedRows() const {
+    return lazyMaze ? lazyMaze->getGeneratedRows() : height;
+  }
   void clear();
   CellType getCellType(const Point &point) const;
   void setCellType(const Point &point, CellType cellType);
   bool isPositionFree(const Point &point) const;
+  // Free cell of the rows revealed so far
   Point randomFreePosition() const;
+  // Free cell from which reachableFrom can be walked to
+  Point randomFreePosition(const Point &reachableFrom) const;
+  // Whether a walk between the points exists around the walls, entities
+  // aside. Always true while a lazy maze is being generated.
+  bool isReachable(const Point &from, const Point &to) const;
   Point getStart() const;
   Point getEnd() const;
   unsigned int getWidth() const;
@@ -24,16 +91,39 @@ public:
   std::vector<Point> getNeighbours(const Point &point) const;
   double distance(const Point &point1, const Point &point2) const;
   bool isValidPoint(const Point &point) const;
+  // Hash of the grid computed from scratch, for checking and for grids
+  // written directly
+  uint64_t computeHash() const;
+  PackedMap pack() const;
+  // Steps to the exit over cells that are not walls, unreachable for walls,
+  // cells cut off from the exit and maps that were not generated
+  uint32_t exitDistance(const Point &point) const;
+  // Rooms and corridors of levels made of rooms, nullptr for mazes
+  std::shared_ptr<const RoomGraph> getRoomGraph() const { return roomGraph; }
+  std::shared_ptr<const ConnectedComponents> getComponents() const {
+    return components;
+  }
 
 private:
   mutable std::mt19937 rng;
   unsigned int width;
   unsigned int height;
+  GridLayout layout;
+  GridStorage storage;
   Point start;
   Point end;
+  // Row by row, computed once per level since walls never change
+  std::shared_ptr<const std::vector<uint32_t>> exitDistances;
+  std::shared_ptr<const RoomGraph> roomGraph;
+  // Areas between the walls, labelled once per level like the distances
+  std::shared_ptr<const ConnectedComponents> components;
+  // Frontier of a maze still being generated, every copy of the map
+  // continues it on its own
+  std::unique_ptr<LazyMazeGenerator> lazyMaze;
 
-  std::vector<std::vector<CellType>>
-  transformToGrid(const std::vector<std::string> &maze) const;
+  Grid transformToGrid(const std::vector<std::string> &maze) const;
+  void computeExitDistances();
+  void labelComponents();
 };
 
 #endif // MAP_H
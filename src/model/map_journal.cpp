@@ -0,0 +1,78 @@
+#include "map_journal.h"
+#include "utils/metrics.h"
+#include <algorithm>
+
+thread_local std::vector<CellChange> *MapJournal::stagingBuffer = nullptr;
+
+MapJournal::MapJournal(size_t _maxChanges) : maxChanges(_maxChanges) {}
+
+MapJournal::StagingScope::StagingScope(std::vector<CellChange> &buffer)
+    : previous(stagingBuffer) {
+  stagingBuffer = &buffer;
+}
+
+MapJournal::StagingScope::~StagingScope() { stagingBuffer = previous; }
+
+MapJournal::SubscriberId MapJournal::subscribe() {
+  auto id = nextId++;
+  subscribers[id] = Subscriber{firstSequence + changes.size(), true};
+  return id;
+}
+
+void MapJournal::unsubscribe(SubscriberId id) { subscribers.erase(id); }
+
+void MapJournal::record(const Point &point, CellType oldType,
+                        CellType newType) {
+  static auto &recorded = MetricsRegistry::getInstance().counter(
+      "md_map_changes_total", "Cell changes recorded in the map journal");
+  recorded.increment();
+
+  if (stagingBuffer) {
+    stagingBuffer->push_back({point, oldType, newType});
+    return;
+  }
+
+  // A subscriber this far behind is cheaper to rebuild than to replay
+  if (changes.size() >= maxChanges) {
+    reset();
+  }
+  changes.push_back({point, oldType, newType});
+}
+
+void MapJournal::append(const std::vector<CellChange> &staged) {
+  if (changes.size() + staged.size() > maxChanges) {
+    reset();
+    if (staged.size() > maxChanges) {
+      return;
+    }
+  }
+  changes.insert(changes.end(), staged.begin(), staged.end());
+}
+
+void MapJournal::reset() {
+  static auto &resets = MetricsRegistry::getInstance().counter(
+      "md_map_journal_resets_total", "Map journal resets forcing a rebuild");
+  resets.increment();
+
+  firstSequence += changes.size();
+  changes.clear();
+  for (auto &[id, subscriber] : subscribers) {
+    subscriber.stale = true;
+    subscriber.cursor = firstSequence;
+  }
+}
+
+void MapJournal::nextTick() {
+  ++tick;
+
+  auto drained = firstSequence + changes.size();
+  for (const auto &[id, subscriber] : subscribers) {
+    if (!subscriber.stale) {
+      drained = std::min(drained, subscriber.cursor);
+    }
+  }
+
+  auto count = static_cast<size_t>(drained - firstSequence);
+  changes.erase(changes.begin(), changes.begin() + count);
+  firstSequence = drained;
+}
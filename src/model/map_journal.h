@@ -0,0 +1,95 @@
+#ifndef MAP_JOURNAL_H
+#define MAP_JOURNAL_H
+
+#include "utils/game_settings.h"
+#include "utils/point.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct CellChange {
+  Point point;
+  CellType oldType;
+  CellType newType;
+};
+
+class MapJournal {
+  /**
+   * @brief Append-only log of map mutations.
+   * Structures derived from the map (dirty regions, walkability, distance
+   * fields, path caches) subscribe once and then drain only the changes
+   * made since their last drain, instead of rescanning the whole grid.
+   * When the map is replaced, or a subscriber falls too far behind, the
+   * journal is reset and every subscriber is told to rebuild.
+   */
+public:
+  using SubscriberId = int;
+
+  explicit MapJournal(size_t maxChanges = 1 << 16);
+
+  // New subscribers start with a rebuild, their first drain returns false
+  SubscriberId subscribe();
+  void unsubscribe(SubscriberId id);
+
+  void record(const Point &point, CellType oldType, CellType newType);
+
+  // Appends changes staged by a worker thread, in their original order
+  void append(const std::vector<CellChange> &staged);
+
+  // While alive, changes recorded by the current thread go to the buffer
+  // instead of the journal, so workers can mutate disjoint parts of the map
+  // and the results are appended in a deterministic order afterwards
+  class StagingScope {
+  public:
+    explicit StagingScope(std::vector<CellChange> &buffer);
+    ~StagingScope();
+
+  private:
+    std::vector<CellChange> *previous;
+  };
+
+  // Forgets all changes and marks every subscriber stale
+  void reset();
+
+  // Discards changes every subscriber has drained and starts a new tick
+  void nextTick();
+
+  // Calls onChange for each change the subscriber has not seen yet, oldest
+  // first. Returns false instead if the subscriber has to rebuild from the
+  // grid, which already reflects every pending change.
+  template <typename Callback> bool drain(SubscriberId id, Callback onChange) {
+    auto &subscriber = subscribers.at(id);
+    auto end = firstSequence + changes.size();
+    if (subscriber.stale) {
+      subscriber.stale = false;
+      subscriber.cursor = end;
+      return false;
+    }
+    for (auto sequence = subscriber.cursor; sequence < end; ++sequence) {
+      onChange(changes[sequence - firstSequence]);
+    }
+    subscriber.cursor = end;
+    return true;
+  }
+
+  size_t size() const { return changes.size(); }
+  uint64_t getTick() const { return tick; }
+
+private:
+  struct Subscriber {
+    uint64_t cursor = 0;
+    bool stale = true;
+  };
+
+  size_t maxChanges;
+  std::vector<CellChange> changes;
+  uint64_t firstSequence = 0; // sequence number of changes[0]
+  uint64_t tick = 0;
+  std::unordered_map<SubscriberId, Subscriber> subscribers;
+  SubscriberId nextId = 0;
+
+  static thread_local std::vector<CellChange> *stagingBuffer;
+};
+
+#endif // MAP_JOURNAL_H
@@ -1,106 +1,821 @@
 #include "model.h"
+#include "algorithms/poisson_disk_sampler.h"
+#include "level_cache.h"
+#include "utils/event_logger.h"
 #include "utils/global_config.h"
+#include "utils/metrics.h"
+#include "utils/profiler.h"
 #include <chrono>
-#include <queue>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <utility>
 
 const int monsterUpdateSpeed =
     GlobalConfig::getInstance().getConfig<int>("MonsterUpdateSpeed");
 
-Model::Model() : running(false), lastUpdate(std::chrono::steady_clock::now()) {}
+// Plain ASCII for the views sent to socket clients, whatever symbols the
+// local terminal uses
+static char viewSymbol(CellType cellType) {
+  switch (cellType) {
+  case CellType::WALL:
+    return '#';
+  case CellType::PLAYER:
+    return '@';
+  case CellType::GOBLIN:
+    return 'g';
+  case CellType::ORC:
+    return 'o';
+  case CellType::TROLL:
+    return 'T';
+  case CellType::DRAGON:
+    return 'D';
+  case CellType::TREASURE:
+    return '*';
+  case CellType::START:
+    return 'S';
+  case CellType::END:
+    return 'E';
+  default:
+    return ' ';
+  }
+}
+
+Model::Model()
+    : commands(
+          GlobalConfig::getInstance().getConfig<int>("MaxPendingMoves", 8)),
+      pathScheduler(std::make_shared<PathScheduler>(
+          GlobalConfig::getInstance().getConfig<int>("PathBudgetPerTick",
+                                                     2000),
+          GlobalConfig::getInstance().getConfig<int>("PathMaxExpansions",
+                                                     20000))),
+      population(
+          GlobalConfig::getInstance().getConfig<int>("RespawnRegionSize", 32),
+          GlobalConfig::getInstance().getConfig<int>("RespawnBudget", 2),
+          GlobalConfig::getInstance().getConfig<int>("RespawnPeriod", 20),
+          GlobalConfig::getInstance().getConfig<double>(
+              "RespawnViewDistance", 15)),
+      running(false), lastUpdate(std::chrono::steady_clock::now()),
+      stateHashCheck(
+          GlobalConfig::getInstance().getConfig<int>("StateHashCheck", 0)),
+      lazyMaze(GlobalConfig::getInstance().getConfig<int>("LazyMaze", 0)),
+      lazyMazeMargin(
+          GlobalConfig::getInstance().getConfig<int>("LazyMazeMargin", 40)),
+      viewRadius(std::max(
+          GlobalConfig::getInstance().getConfig<int>("PlayerViewRadius", 7),
+          0)),
+      rng(std::random_device{}()) {
+  auto shardWidth = GlobalConfig::getInstance().getConfig<int>("ShardWidth", 0);
+  if (shardWidth > 0) {
+    shardedSimulation = std::make_unique<ShardedSimulation>(
+        shardWidth,
+        GlobalConfig::getInstance().getConfig<int>("SimulationThreads", 0));
+  }
+  if (GlobalConfig::getInstance().getConfig<int>("CrowdSteering", 0)) {
+    crowdSteering = std::make_unique<CrowdSteering>(
+        GlobalConfig::getInstance().getConfig<double>("CrowdSeparation", 1.0),
+        GlobalConfig::getInstance().getConfig<double>("CrowdAlignment", 0.5));
+  }
+
+  // Bots join like socket clients, once the first level is loaded
+  auto botCount = GlobalConfig::getInstance().getConfig<int>("BotCount", 0);
+  for (int i = 0; i < botCount; ++i) {
+    bots.push_back(commands.reservePlayerId());
+    commands.submit(CommandType::JOIN, bots.back());
+  }
+}
+
+Model::Model(const Model &other)
+    : commands(other.commands),
+      info(std::make_shared<InfoDeque>(*other.info)),
+      map(std::make_shared<Map>(*other.map)),
+      floors(other.floors), currentFloor(other.currentFloor),
+      pathScheduler(std::make_shared<PathScheduler>(
+          other.pathScheduler->getBudgetPerTick(),
+          other.pathScheduler->getMaxExpansions())),
+      population(other.population,
+                 {map,
+                  [this](const Point &point) { return nearestPlayer(point); },
+                  pathScheduler}),
+      running(other.running.load()), bots(other.bots),
+      lastUpdate(other.lastUpdate), fightsThisTick(other.fightsThisTick),
+      entityHash(other.entityHash), stateHashCheck(other.stateHashCheck),
+      lazyMaze(other.lazyMaze), lazyMazeMargin(other.lazyMazeMargin),
+      viewRadius(other.viewRadius), rng(other.rng), forked(true) {
+  // Same strips as the original, so the fork plays out the same way, but
+  // without worker threads of its own
+  if (other.shardedSimulation) {
+    shardedSimulation = std::make_unique<ShardedSimulation>(
+        other.shardedSimulation->getStripWidth(), 1);
+  }
+  if (other.crowdSteering) {
+    crowdSteering = std::make_unique<CrowdSteering>(
+        other.crowdSteering->getSeparationWeight(),
+        other.crowdSteering->getAlignmentWeight());
+  }
+
+  std::unordered_map<Entity *, Entity *> counterparts;
+  counterparts.reserve(other.players.size() + other.monsters.size() +
+                       other.treasures.size());
+  players.reserve(other.players.size());
+  for (const auto &original : other.players) {
+    players.push_back(makeTracked<MemoryTag::ENTITIES, Player>(*original));
+    counterparts[original.get()] = players.back().get();
+    if (original == other.player) {
+      player = players.back();
+    }
+  }
+
+  MonsterWorld world{
+      map, [this](const Point &point) { return nearestPlayer(point); },
+      pathScheduler};
+  monsters.reserve(other.monsters.size());
+  for (const auto &original : other.monsters) {
+    monsters.push_back(original->clone(world));
+    counterparts[original.get()] = monsters.back().get();
+  }
+
+  treasures.reserve(other.treasures.size());
+  for (const auto &[position, original] : other.treasures) {
+    auto copy = makeTracked<MemoryTag::ENTITIES, Treasure>(*original);
+    counterparts[original.get()] = copy.get();
+    treasures.emplace(position, std::move(copy));
+  }
+
+  spatialIndex.copyFrom(other.spatialIndex, [&counterparts](Entity *entity) {
+    return counterparts.at(entity);
+  });
+}
+
+std::unique_ptr<Model> Model::fork() const {
+  static auto &forks = MetricsRegistry::getInstance().counter(
+      "md_model_forks_total", "Copies of the world made for lookahead");
+  forks.increment();
+  return std::unique_ptr<Model>(new Model(*this));
+}
+
+void Model::logEvent(EventType type, int32_t arg0, int32_t arg1,
+                     int32_t arg2) {
+  // Forks are hypothetical worlds, the event log only records the real one
+  if (!forked) {
+    EventLogger::getInstance().log(type, arg0, arg1, arg2);
+  }
+}
 
 void Model::restart() {
+  Profiler::PhaseScope phase(ProfilePhase::LEVEL_LOAD);
 
   if (!player || !player->isAlive()) {
-    player = std::make_shared<Player>();
+    player = makeTracked<MemoryTag::ENTITIES, Player>();
   }
-  map = std::make_shared<Map>(
-      GlobalConfig::getInstance().getConfig<int>("MapWidth"),
-      GlobalConfig::getInstance().getConfig<int>("MapHeight"));
+  // Remote players who are still alive stay for the new game
+  players.erase(std::remove_if(players.begin(), players.end(),
+                               [this](const std::shared_ptr<Player> &other) {
+                                 return other == player || !other->isAlive();
+                               }),
+                players.end());
+  players.insert(players.begin(), player);
+  // Searches still running refer to the previous level
+  pathScheduler->clear();
   info = std::make_shared<InfoDeque>(
       GlobalConfig::getInstance().getConfig<int>("MessageQueueSize"));
 
-  auto addMonsters = [this](const std::string &type, auto monsterMaker) {
-    const int monsterCount = GlobalConfig::getInstance().getConfig<int>(type);
-    monsters.reserve(monsters.size() + monsterCount);
+  floors.clear();
+  currentFloor = 0;
+  generateFloor();
+  enterFloor();
+  info->addMessage("Welcome on the new level!");
+}
+
+void Model::changeFloor(size_t target) {
+  Profiler::PhaseScope phase(ProfilePhase::LEVEL_LOAD);
+  bool descending = target > currentFloor;
 
-    for (int i = 0; i < monsterCount; i++) {
-      monsters.push_back(
-          std::make_shared<decltype(monsterMaker)>(monsterMaker));
+  pathScheduler->clear();
+  for (const auto &other : players) {
+    if (other->isAlive()) {
+      map->setCellType(other->position, CellType::EMPTY);
     }
+  }
+  floors.store(currentFloor, {map, monsters, treasures});
+  monsters.clear();
+  treasures.clear();
+  currentFloor = target;
+
+  if (target == floors.size()) {
+    generateFloor();
+  } else {
+    auto floor = floors.load(
+        target, MonsterWorld{nullptr,
+                             [this](const Point &point) {
+                               return nearestPlayer(point);
+                             },
+                             pathScheduler});
+    map = floor.map;
+    monsters = std::move(floor.monsters);
+    treasures = std::move(floor.treasures);
+    // The party arrives next to the stairs it took
+    auto stairs = descending ? map->getStart() : map->getEnd();
+    auto nextToStairs = map->getNeighbours(stairs);
+    placePlayers(nextToStairs.empty() ? map->randomFreePosition()
+                                      : nextToStairs.front());
+  }
+  enterFloor();
+  info->addMessage("Welcome on floor " + std::to_string(currentFloor + 1) +
+                   "!");
+}
+
+void Model::generateFloor() {
+  // A fixed LevelSeed gives every run the same floors, which the level
+  // cache then only generates once. Random seeds never come back, their
+  // floors would only push useful levels out of the cache.
+  LevelKey key;
+  auto levelSeed = GlobalConfig::getInstance().getConfig<int>("LevelSeed", 0);
+  key.seed = levelSeed != 0 ? levelSeed + currentFloor : rng();
+  key.width = GlobalConfig::getInstance().getConfig<int>("MapWidth");
+  key.height = GlobalConfig::getInstance().getConfig<int>("MapHeight");
+  key.algorithm = parseMazeGeneratorAlgorithm(
+      GlobalConfig::getInstance().getConfig<std::string>("MazeAlgorithm",
+                                                         "dfs"));
+  auto layout =
+      parseGridLayout(GlobalConfig::getInstance().getConfig<std::string>(
+          "GridLayout", DEFAULT_GRID_LAYOUT));
+  auto storage =
+      parseGridStorage(GlobalConfig::getInstance().getConfig<std::string>(
+          "GridStorage", DEFAULT_GRID_STORAGE));
+  if (lazyMaze) {
+    // Only the rows around the start exist before anyone moves
+    map = std::make_shared<Map>(key.width, key.height, layout, storage);
+    map->loadLazyLevel(key.seed);
+    map->revealRows(map->getStart().y + lazyMazeMargin + 1);
+  } else if (levelSeed != 0) {
+    map = std::make_shared<Map>(*LevelCache::getInstance().get(key), layout,
+                                storage);
+  } else {
+    map = std::make_shared<Map>(key.width, key.height, layout, storage);
+    map->loadLevel(key.seed, key.algorithm);
+  }
+  map->setCellType(map->getEnd(), CellType::END);
+  if (currentFloor == 0) {
+    placePlayers(map->getStart());
+  } else {
+    // Stairs up to the previous floor, the party arrives next to them
+    map->setCellType(map->getStart(), CellType::START);
+    auto nextToStairs = map->getNeighbours(map->getStart());
+    placePlayers(nextToStairs.empty() ? map->randomFreePosition()
+                                      : nextToStairs.front());
+  }
+
+  populateRows(0, map->getRevealedRows());
+}
+
+Model::Spawned Model::populateRows(unsigned int top, unsigned int bottom) {
+  Spawned spawned;
+  if (bottom <= top) {
+    return spawned;
+  }
+  // Every band of rows gets its share of each count, so a lazy maze is
+  // populated evenly as it is carved instead of all around the start
+  auto share = [this, top, bottom](int count) {
+    auto total = static_cast<uint64_t>(std::max(count, 0));
+    return static_cast<size_t>(total * bottom / map->getHeight() -
+                               total * top / map->getHeight());
+  };
+  auto isFree = [this](const Point &point) {
+    return map->isPositionFree(point) &&
+           map->isReachable(map->getStart(), point);
   };
 
-  addMonsters("GoblinsCount", Goblin());
-  addMonsters("TrollsCount", Troll());
-  addMonsters("DragonsCount", Dragon());
+  // Spawns keep a distance per kind (the <Kind>Spacing options), so that
+  // monsters do not start in packs. Only where the party can get to,
+  // anything walled off would be left behind on the floor for good
+  PoissonDiskSampler sampler(
+      map->getWidth(), bottom - top,
+      [&isFree, top](const Point &point) {
+        return isFree(Point(point.x, point.y + static_cast<int>(top)));
+      },
+      rng());
+  auto spawn = [&](size_t count, double spacing,
+                   const std::function<void(const Point &)> &place) {
+    auto positions = sampler.sample(count, spacing);
+    for (const auto &position : positions) {
+      place(Point(position.x, position.y + static_cast<int>(top)));
+    }
+    if (positions.size() == count) {
+      return;
+    }
+    // Bands too small for the spacing take the rest on any free cell, as
+    // many as there are
+    std::vector<Point> freeCells;
+    for (auto y = top; y < bottom; ++y) {
+      for (unsigned int x = 0; x < map->getWidth(); ++x) {
+        if (isFree(Point(x, y))) {
+          freeCells.emplace_back(x, y);
+        }
+      }
+    }
+    for (auto i = positions.size(); i < count && !freeCells.empty(); ++i) {
+      auto picked = rng() % freeCells.size();
+      place(freeCells[picked]);
+      freeCells[picked] = freeCells.back();
+      freeCells.pop_back();
+    }
+  };
 
-  // Adding Orcs separately as they have different parameters
-  auto orcsCount = GlobalConfig::getInstance().getConfig<int>("OrcsCount");
-  monsters.reserve(monsters.size() + orcsCount);
-  for (auto i = 0; i < orcsCount; i++) {
-    monsters.push_back(std::make_shared<Orc>(map, player));
+  auto orc = [this]() -> std::shared_ptr<Monster> {
+    return makeTracked<MemoryTag::ENTITIES, Orc>(
+        map, [this](const Point &point) { return nearestPlayer(point); },
+        pathScheduler);
+  };
+  const struct {
+    std::string kind;
+    double spacing;
+    std::function<std::shared_ptr<Monster>()> make;
+  } kinds[] = {
+      {"Goblins", 4, [] { return makeTracked<MemoryTag::ENTITIES, Goblin>(); }},
+      {"Trolls", 6, [] { return makeTracked<MemoryTag::ENTITIES, Troll>(); }},
+      {"Dragons", 10,
+       [] { return makeTracked<MemoryTag::ENTITIES, Dragon>(); }},
+      {"Orcs", 6, orc}};
+  auto &config = GlobalConfig::getInstance();
+  for (const auto &[kind, spacing, make] : kinds) {
+    auto count = share(config.getConfig<int>(kind + "Count"));
+    monsters.reserve(monsters.size() + count);
+    spawn(count, config.getConfig<double>(kind + "Spacing", spacing),
+          [&, &make = make](const Point &position) {
+            auto monster = make();
+            monster->position = position;
+            map->setCellType(position, monster->cellType);
+            monsters.push_back(monster);
+            spawned.monsters.push_back(monster);
+          });
   }
 
-  loadMap();
+  spawn(share(config.getConfig<int>("TreasureCount", 20)),
+        config.getConfig<double>("TreasureSpacing", 5),
+        [&](const Point &position) {
+          auto treasure = makeTracked<MemoryTag::ENTITIES, Treasure>();
+          treasure->move(position);
+          treasures.emplace(position, treasure);
+          map->setCellType(position, CellType::TREASURE);
+          spawned.treasures.push_back(treasure);
+        });
+  return spawned;
 }
 
-void Model::loadMap() {
-  map->loadLevel();
-  map->setCellType(map->getStart(), CellType::PLAYER);
-  player->move(map->getStart());
+void Model::placePlayers(const Point &arrival) {
+  auto leader = partyLeader();
+  if (!leader) {
+    return;
+  }
+  leader->move(arrival);
+  map->setCellType(arrival, CellType::PLAYER);
+  for (const auto &other : players) {
+    if (other != leader && other->isAlive()) {
+      auto position = map->randomFreePosition(arrival);
+      other->move(position);
+      map->setCellType(position, CellType::PLAYER);
+    }
+  }
+}
 
+void Model::enterFloor() {
+  spatialIndex.reset(map->getWidth(), map->getHeight());
+  entityHash.reset();
+  for (const auto &other : players) {
+    if (other->isAlive()) {
+      spatialIndex.insert(other.get());
+      entityHash.toggle(other->stateKey());
+    }
+  }
   for (const auto &monster : monsters) {
-    auto position = map->randomFreePosition();
-    monster->position = position;
-    map->setCellType(position, monster->cellType);
+    spatialIndex.insert(monster.get());
+    entityHash.toggle(monster->stateKey());
   }
-
-  auto treasuerCount =
-      GlobalConfig::getInstance().getConfig<int>("TreasureCount");
-  for (int i = 0; i < treasuerCount; ++i) {
-    auto treasurePtr = std::make_shared<Treasure>();
-    auto position = map->randomFreePosition();
-    treasurePtr->move(position);
-    treasures.emplace(position, std::move(treasurePtr));
-    map->setCellType(position, CellType::TREASURE);
+  for (const auto &[position, treasure] : treasures) {
+    spatialIndex.insert(treasure.get());
+    entityHash.toggle(treasure->stateKey());
   }
+  population.reset(map->getWidth(), map->getHeight(), monsters);
 
-  map->setCellType(map->getEnd(), CellType::END);
-  info->addMessage("Welcome on the new level!");
+  logEvent(EventType::LEVEL_LOADED, map->getWidth(), map->getHeight(),
+           static_cast<int32_t>(currentFloor));
 }
 
 void Model::update() {
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - lastUpdate);
+  tick(elapsed.count() >= monsterUpdateSpeed);
+}
+
+void Model::step() { tick(true); }
+
+void Model::tick(bool moveMonsters) {
+  static auto &tickDuration = MetricsRegistry::getInstance().histogram(
+      "md_tick_duration_seconds", "Duration of Model::update", 1e-9);
+  static auto &ticks = MetricsRegistry::getInstance().counter(
+      "md_ticks_total", "Number of Model::update calls");
+  Profiler::PhaseScope phase(ProfilePhase::UPDATE);
+  ScopedTimer timer(tickDuration);
+  ticks.increment();
+  map->journal.nextTick();
+
   auto now = std::chrono::steady_clock::now();
-  auto elapsed =
-      std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate);
 
-  while (!playerMoves.empty()) {
-    auto offset = playerMoves.front();
-    playerMoves.pop();
-    attemptPlayerMove(player, offset);
+  applyCommands();
+  prefetchFloors();
+  revealMaze();
+
+  auto leader = partyLeader();
+  pathScheduler->run((leader ? leader : player)->position);
+
+  if (moveMonsters) {
+    updateMonsters();
+    lastUpdate = now;
+  }
+
+  checkStateHash();
+  publishViews();
+}
+
+void Model::publishViews() {
+  for (const auto &other : players) {
+    publishView(*other);
   }
+}
 
-  if (elapsed.count() < monsterUpdateSpeed) {
+void Model::publishView(const Player &viewer) {
+  // Forks are hypothetical worlds, nobody is watching them
+  if (forked || &viewer == player.get() ||
+      std::find(bots.begin(), bots.end(), viewer.id) != bots.end()) {
     return;
   }
+  views.publish(viewer.id, viewOf(viewer));
+}
+
+std::string Model::viewOf(const Player &viewer) const {
+  std::ostringstream view;
+  if (!viewer.isAlive()) {
+    view << viewer.toString() << " was defeated.\n\n";
+    return view.str();
+  }
+  view << viewer.toString() << "  Health " << viewer.health << "/"
+       << viewer.getMaxHealth() << "  Level " << viewer.level
+       << "  Position " << viewer.position.x << "," << viewer.position.y
+       << "  Floor " << currentFloor + 1 << "\n";
+  for (int dy = -viewRadius; dy <= viewRadius; ++dy) {
+    for (int dx = -viewRadius; dx <= viewRadius; ++dx) {
+      Point point(viewer.position.x + dx, viewer.position.y + dy);
+      view << (map->isValidPoint(point) ? viewSymbol(map->getCellType(point))
+                                        : ' ');
+    }
+    view << '\n';
+  }
+  // An empty line ends every view
+  view << '\n';
+  return view.str();
+}
+
+void Model::prefetchFloors() {
+  // Close enough to stairs that the floor behind them is likely next
+  const double prefetchDistance = 10;
+  auto leader = partyLeader();
+  if (!leader) {
+    return;
+  }
+  if (currentFloor > 0 &&
+      leader->position.distance(map->getStart()) < prefetchDistance) {
+    floors.prefetch(currentFloor - 1);
+  }
+  if (leader->position.distance(map->getEnd()) < prefetchDistance) {
+    floors.prefetch(currentFloor + 1);
+  }
+}
+
+void Model::revealMaze() {
+  if (map->isFullyGenerated()) {
+    return;
+  }
+  // Far enough below the lowest player that nobody sees the maze end
+  int lowest = 0;
+  for (const auto &other : players) {
+    if (other->isAlive()) {
+      lowest = std::max(lowest, other->position.y);
+    }
+  }
+  auto populated = map->getRevealedRows();
+  map->revealRows(lowest + lazyMazeMargin + 1);
+
+  auto spawned = populateRows(populated, map->getRevealedRows());
+  for (const auto &monster : spawned.monsters) {
+    population.adopt(*monster);
+  }
+  auto entities = std::vector<std::shared_ptr<Entity>>(
+      spawned.monsters.begin(), spawned.monsters.end());
+  entities.insert(entities.end(), spawned.treasures.begin(),
+                  spawned.treasures.end());
+  for (const auto &entity : entities) {
+    spatialIndex.insert(entity.get());
+    entityHash.toggle(entity->stateKey());
+    logEvent(EventType::ENTITY_SPAWNED, static_cast<int32_t>(entity->cellType),
+             entity->position.x, entity->position.y);
+  }
+}
+
+void Model::updateMonsters() {
+  static auto &fightsPerTick = MetricsRegistry::getInstance().histogram(
+      "md_fights_per_tick", "Fights started per monster tick");
+  static auto &monstersAlive = MetricsRegistry::getInstance().gauge(
+      "md_monsters_alive", "Monsters alive on the current level");
+  static auto &monstersPooled = MetricsRegistry::getInstance().gauge(
+      "md_monsters_pooled", "Dead monsters kept for respawning");
+  static auto &respawns = MetricsRegistry::getInstance().counter(
+      "md_monsters_respawned_total", "Dead monsters brought back");
+
+  // Bot moves go through the buffer like everyone else's, next tick
+  updateBots();
+
+  if (crowdSteering) {
+    crowdSteering->plan(*map, monsters);
+  }
+  if (shardedSimulation) {
+    updateMonstersSharded();
+  } else {
+    for (size_t index = 0; index < monsters.size(); ++index) {
+      if (auto step = monsterStep(index)) {
+        attemptMonsterMove(monsters[index], *step);
+      }
+    }
+  }
+
+  population.collect(monsters);
+  for (const auto &monster :
+       population.respawn(*map, players, monsters, rng)) {
+    map->setCellType(monster->position, monster->cellType);
+    spatialIndex.insert(monster.get());
+    entityHash.toggle(monster->stateKey());
+    logEvent(EventType::ENTITY_SPAWNED,
+             static_cast<int32_t>(monster->cellType), monster->position.x,
+             monster->position.y);
+    respawns.increment();
+  }
+  // The local player stays in the list, its death ends the game
+  for (const auto &other : players) {
+    if (other != player && !other->isAlive()) {
+      // Their last view, nobody publishes for them once they are gone
+      publishView(*other);
+    }
+  }
+  players.erase(std::remove_if(players.begin(), players.end(),
+                               [this](const std::shared_ptr<Player> &other) {
+                                 return other != player && !other->isAlive();
+                               }),
+                players.end());
+
+  fightsPerTick.record(fightsThisTick);
+  fightsThisTick = 0;
+  monstersAlive.set(static_cast<int64_t>(monsters.size()));
+  monstersPooled.set(static_cast<int64_t>(population.pooled()));
+}
+
+void Model::checkStateHash() {
+  static auto &mismatches = MetricsRegistry::getInstance().counter(
+      "md_state_hash_mismatches_total",
+      "Ticks whose state hash differed from a full recompute");
+
+  auto hash = stateHash();
+  logEvent(EventType::STATE_HASH, static_cast<int32_t>(hash),
+           static_cast<int32_t>(hash >> 32),
+           static_cast<int32_t>(map->journal.getTick()));
+  if (stateHashCheck && hash != computeStateHash()) {
+    mismatches.increment();
+  }
+}
+
+uint64_t Model::stateHash() const { return map->hash.get() ^ entityHash.get(); }
 
+uint64_t Model::computeStateHash() const {
+  auto hash = map->computeHash();
+  for (const auto &other : players) {
+    if (other->isAlive()) {
+      hash ^= other->stateKey();
+    }
+  }
   for (const auto &monster : monsters) {
-    attemptMonsterMove(monster, monster->getVelocity());
+    if (monster->isAlive()) {
+      hash ^= monster->stateKey();
+    }
+  }
+  for (const auto &[position, treasure] : treasures) {
+    hash ^= treasure->stateKey();
+  }
+  return hash;
+}
+
+void Model::updateMonstersSharded() {
+  // Moves inside a strip only touch cells, buckets and monsters of that
+  // strip. Fights change the player and the message log, so they are
+  // deferred to the serial border phase like moves into other strips.
+  auto localStep = [this](size_t index,
+                          const ShardedSimulation::Strip &strip)
+      -> std::optional<Point> {
+    auto step = monsterStep(index);
+    if (!step) {
+      return std::nullopt;
+    }
+    const auto &monster = monsters[index];
+    auto direction = *step;
+    auto target = monster->position + direction;
+    if (!strip.contains(target) || isPlayer(target)) {
+      return target;
+    }
+    attemptMonsterMove(monster, direction);
+    return std::nullopt;
+  };
+
+  auto borderStep = [this](const std::shared_ptr<Monster> &monster,
+                           const Point &target) {
+    if (monster->isAlive()) {
+      attemptMonsterMove(monster, target - monster->position);
+    }
+  };
+
+  shardedSimulation->tick(*map, monsters, localStep, borderStep);
+}
+
+std::optional<Point> Model::monsterStep(size_t index) {
+  if (!crowdSteering) {
+    return monsters[index]->getVelocity();
+  }
+  if (crowdSteering->waits(index)) {
+    return std::nullopt;
   }
+  return crowdSteering->stepOf(index);
+}
+
+void Model::applyCommands() {
+  static auto &playersConnected = MetricsRegistry::getInstance().gauge(
+      "md_players_connected", "Players in the dungeon, including bots");
 
-  monsters.erase(std::remove_if(monsters.begin(), monsters.end(),
-                                [](const std::shared_ptr<Monster> &monster) {
-                                  return !monster->isAlive();
-                                }),
-                 monsters.end());
+  for (const auto &command : commands.take()) {
+    switch (command.type) {
+    case CommandType::JOIN:
+      addPlayer(command.playerId);
+      break;
+    case CommandType::LEAVE:
+      removePlayer(command.playerId);
+      break;
+    case CommandType::MOVE: {
+      // Checked against the world as it is now, earlier commands of this
+      // batch may have taken the target cell or killed the mover
+      auto mover = findPlayer(command.playerId);
+      if (mover && mover->isAlive()) {
+        attemptPlayerMove(mover, command.direction);
+      }
+      break;
+    }
+    }
+  }
 
-  lastUpdate = now;
+  playersConnected.set(static_cast<int64_t>(players.size()));
 }
 
-void Model::fight(const std::shared_ptr<Monster> &monster) {
+void Model::addPlayer(int id) {
+  if (findPlayer(id)) {
+    return;
+  }
+
+  auto joined = makeTracked<MemoryTag::ENTITIES, Player>(id);
+  auto position = map->randomFreePosition(map->getStart());
+  joined->move(position);
+  map->setCellType(position, CellType::PLAYER);
+  spatialIndex.insert(joined.get());
+  entityHash.toggle(joined->stateKey());
+  players.push_back(joined);
+  info->addMessage(joined->toString() + " joined the dungeon.");
+}
+
+void Model::removePlayer(int id) {
+  auto leaving =
+      std::find_if(players.begin(), players.end(),
+                   [id](const std::shared_ptr<Player> &other) {
+                     return other->id == id;
+                   });
+  if (leaving == players.end() || *leaving == player) {
+    return;
+  }
+
+  if ((*leaving)->isAlive()) {
+    map->setCellType((*leaving)->position, CellType::EMPTY);
+    spatialIndex.remove(leaving->get(), (*leaving)->position);
+    entityHash.toggle((*leaving)->stateKey());
+  }
+  info->addMessage((*leaving)->toString() + " left the dungeon.");
+  views.remove(id);
+  players.erase(leaving);
+}
+
+void Model::updateBots() {
+  const Point directions[] = {Direction::UP, Direction::DOWN, Direction::LEFT,
+                              Direction::RIGHT};
+  auto isTreasureEntity = [](const Entity &entity) {
+    return entity.cellType == CellType::TREASURE;
+  };
+
+  for (auto id : bots) {
+    auto bot = findPlayer(id);
+    if (!bot || !bot->isAlive()) {
+      continue;
+    }
+
+    // Head for the closest treasure, with a random step now and then so
+    // walls do not trap the bot for good
+    auto direction = directions[rng() % 4];
+    auto goal = spatialIndex.nearest(bot->position, 1, isTreasureEntity);
+    if (!goal.empty() && rng() % 4 != 0) {
+      auto offset = goal.front()->position - bot->position;
+      if (std::abs(offset.x) >= std::abs(offset.y)) {
+        direction = offset.x < 0 ? Direction::LEFT : Direction::RIGHT;
+      } else {
+        direction = offset.y < 0 ? Direction::UP : Direction::DOWN;
+      }
+    } else if (goal.empty()) {
+      // Every treasure is taken, follow the exit distances to the stairs
+      for (const auto &step : directions) {
+        if (map->exitDistance(bot->position + step) <
+            map->exitDistance(bot->position + direction)) {
+          direction = step;
+        }
+      }
+    }
+    commands.submit(CommandType::MOVE, id, direction);
+  }
+}
+
+std::shared_ptr<Player> Model::findPlayer(int id) const {
+  for (const auto &other : players) {
+    if (other->id == id) {
+      return other;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<Player> Model::partyLeader() const {
+  if (player->isAlive()) {
+    return player;
+  }
+  for (const auto &other : players) {
+    if (other->isAlive()) {
+      return other;
+    }
+  }
+  return nullptr;
+}
+
+bool Model::hasRemotePlayers() const {
+  return std::any_of(players.begin(), players.end(),
+                     [this](const std::shared_ptr<Player> &other) {
+                       return other != player && other->isAlive();
+                     });
+}
+
+std::shared_ptr<Player> Model::playerAt(const Point &point) const {
+  for (const auto &other : players) {
+    if (other->isAlive() && other->position == point) {
+      return other;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<Player> Model::nearestPlayer(const Point &point) const {
+  std::shared_ptr<Player> nearest;
+  auto nearestDistance = std::numeric_limits<double>::max();
+  for (const auto &other : players) {
+    if (!other->isAlive()) {
+      continue;
+    }
+    auto distance = point.distance(other->position);
+    if (distance < nearestDistance) {
+      nearest = other;
+      nearestDistance = distance;
+    }
+  }
+  return nearest;
+}
+
+void Model::fight(const std::shared_ptr<Monster> &monster,
+                  const std::shared_ptr<Player> &player) {
+  static auto &fights = MetricsRegistry::getInstance().counter(
+      "md_fights_total", "Number of fights");
+  fights.increment();
+  ++fightsThisTick;
 
   auto attack = [&](const auto &attacker, const auto &defender,
                     auto &messages) {
-    double successRate = (rand() % 100) / 100.0; // random value between 0 and 1
+    double successRate = (rng() % 100) / 100.0; // random value between 0 and 1
     if (successRate > 0.85) {                    // 15% chance of attack missing
       messages.push_back(attacker->toString() + " misses " +
                          defender->toString() + ".");
@@ -120,27 +835,39 @@ void Model::fight(const std::shared_ptr<Monster> &monster) {
     }
 
     if (!monster->isAlive()) {
+      logEvent(EventType::ENTITY_DEFEATED,
+               static_cast<int32_t>(monster->cellType), monster->position.x,
+               monster->position.y);
       messages.push_back(monster->toString() + " was defeated!");
       player->addExperience(monsterExpMap[monster->cellType]);
 
     } else if (!player->isAlive()) {
-      messages.push_back("Player was defeated!");
+      logEvent(EventType::ENTITY_DEFEATED,
+               static_cast<int32_t>(player->cellType), player->position.x,
+               player->position.y);
+      messages.push_back(player->toString() + " was defeated!");
     }
   };
 
   auto updateMapAfterFight = [&](const auto &defeatedMonster) {
     if (!defeatedMonster->isAlive()) {
       map->setCellType(defeatedMonster->position, CellType::EMPTY);
+      spatialIndex.remove(defeatedMonster.get(), defeatedMonster->position);
     }
 
     if (!player->isAlive()) {
       map->setCellType(player->position, CellType::EMPTY);
+      spatialIndex.remove(player.get(), player->position);
     } else {
       map->setCellType(player->position, player->cellType);
     }
   };
 
+  // Both leave the state hash and come back as they are after the fight
+  entityHash.toggle(monster->stateKey() ^ player->stateKey());
   info->addMessage("New fight starts!");
+  logEvent(EventType::FIGHT_STARTED, static_cast<int32_t>(monster->cellType),
+           monster->position.x, monster->position.y);
 
   while (player->isAlive() && monster->isAlive()) {
     std::vector<std::string> roundMessages;
@@ -154,13 +881,20 @@ void Model::fight(const std::shared_ptr<Monster> &monster) {
   }
 
   updateMapAfterFight(monster);
+  if (monster->isAlive()) {
+    entityHash.toggle(monster->stateKey());
+  }
+  if (player->isAlive()) {
+    entityHash.toggle(player->stateKey());
+  }
 }
 
-void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
+void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure,
+                            const std::shared_ptr<Player> &player) {
 
   // Initialize success rate (you might want to tweak the numbers depending on
   // your game balance)
-  double successRate = (rand() % 100) / 100.0; // random value between 0 and 1
+  double successRate = (rng() % 100) / 100.0; // random value between 0 and 1
 
   // Define the mechanism of exploring treasure
   auto explore = [&](const auto &explorer, const auto &treasure,
@@ -187,6 +921,9 @@ void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
       break;
     }
 
+    logEvent(EventType::TREASURE_EXPLORED,
+             static_cast<int32_t>(treasure->getBonusType()), bonus);
+
     // Display a message for successful exploration
     messages.push_back(explorer->toString() + " successfully explores " +
                        treasure->toString() + " for a bonus of " +
@@ -197,9 +934,13 @@ void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
   auto updateMapAfterExploration = [&](const auto &explorer,
                                        const auto &exploredTreasure) {
     map->setCellType(exploredTreasure->position, CellType::EMPTY);
+    spatialIndex.remove(exploredTreasure.get(), exploredTreasure->position);
     treasures.erase(exploredTreasure->position);
   };
 
+  // The treasure is used up, the explorer comes back with the bonus
+  entityHash.toggle(treasure->stateKey() ^ player->stateKey());
+
   // Display a message for starting treasure exploration
   info->addMessage("Treasure exploration starts!");
 
@@ -211,11 +952,15 @@ void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
   // Update the map after exploration
   updateMapAfterExploration(player, treasure);
 
+  entityHash.toggle(player->stateKey());
+
   // Display exploration messages
   info->addMessage(explorationMessages);
 }
 
-void Model::queuePlayerMove(const Point &point) { playerMoves.push(point); }
+void Model::queuePlayerMove(const Point &point) {
+  commands.submit(CommandType::MOVE, CommandBuffer::localPlayerId, point);
+}
 
 void Model::attemptPlayerMove(const std::shared_ptr<Player> &player,
                               const Point &direction) {
@@ -225,22 +970,35 @@ void Model::attemptPlayerMove(const std::shared_ptr<Player> &player,
   if (isWall(newPos) || isMonster(newPos)) {
     for (const auto &monster : monsters) {
       if (monster->position == newPos) {
-        fight(monster);
-        monsters.erase(std::remove(monsters.begin(), monsters.end(), monster),
-                       monsters.end());
+        fight(monster, player);
+        // A monster that wins stays, e.g. after killing a bot
+        if (!monster->isAlive()) {
+          auto defeated = monster;
+          monsters.erase(
+              std::remove(monsters.begin(), monsters.end(), defeated),
+              monsters.end());
+          population.release(std::move(defeated));
+        }
         break;
       }
     }
     return;
+  } else if (isPlayer(newPos)) {
+    // Players block each other, whoever moved first this tick keeps the cell
+    return;
   } else if (isTreasure(newPos)) {
-    exploreTreasure(treasures[newPos]);
+    exploreTreasure(treasures[newPos], player);
   }
 
-  else if (isExit(newPos)) {
-    restart();
+  else if (isExit(newPos) || isEntrance(newPos)) {
+    // Only the leader of the party can take the stairs
+    if (player == partyLeader()) {
+      changeFloor(isExit(newPos) ? currentFloor + 1 : currentFloor - 1);
+    }
     return;
   }
   updateEntityPosition(player, currentPos, newPos);
+  logEvent(EventType::PLAYER_MOVED, newPos.x, newPos.y);
 }
 
 void Model::attemptMonsterMove(const std::shared_ptr<Monster> &monster,
@@ -248,11 +1006,18 @@ void Model::attemptMonsterMove(const std::shared_ptr<Monster> &monster,
   auto currentPos = monster->position;
   auto newPos = currentPos + direction;
 
-  if (isWall(newPos) || isMonster(newPos) || isExit(newPos)) {
+  if (isWall(newPos) || isMonster(newPos) || isExit(newPos) ||
+      isEntrance(newPos)) {
+    static auto &blocked = MetricsRegistry::getInstance().counter(
+        "md_monster_moves_blocked_total",
+        "Monster moves into walls, stairs or other monsters");
+    blocked.increment();
     monster->randomizeVelocity();
     return;
   } else if (isPlayer(newPos)) {
-    fight(monster);
+    if (auto target = playerAt(newPos)) {
+      fight(monster, target);
+    }
     return;
   }
 
@@ -264,7 +1029,10 @@ void Model::updateEntityPosition(const std::shared_ptr<Entity> &entity,
   auto cellType = map->getCellType(oldPos);
   map->setCellType(oldPos, CellType::EMPTY);
   map->setCellType(newPos, cellType);
+  spatialIndex.move(entity.get(), oldPos, newPos);
+  entityHash.toggle(entity->stateKey());
   entity->move(newPos);
+  entityHash.toggle(entity->stateKey());
 }
 
 std::unordered_map<std::string, std::string> Model::getPlayerStats() {
@@ -272,6 +1040,7 @@ std::unordered_map<std::string, std::string> Model::getPlayerStats() {
   std::unordered_map<std::string, std::string> result;
 
   result["Level"] = std::to_string(player->level);
+  result["Floor"] = std::to_string(currentFloor + 1);
   result["Health"] = std::to_string(player->health);
   result["MaxHealth"] = std::to_string(player->getMaxHealth());
   result["Experience"] = std::to_string(player->exp);
@@ -294,6 +1063,10 @@ bool Model::isExit(const Point &point) {
   return map->getCellType(point) == CellType::END;
 }
 
+bool Model::isEntrance(const Point &point) {
+  return map->getCellType(point) == CellType::START;
+}
+
 bool Model::isTreasure(const Point &point) {
   return map->getCellType(point) == CellType::TREASURE;
 }
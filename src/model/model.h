@@ -1,15 +1,29 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include "command_buffer.h"
+#include "crowd_steering.h"
 #include "entities/monster.h"
 #include "entities/player.h"
 #include "entities/treasure.h"
+#include "floor_stack.h"
 #include "map.h"
+#include "path_scheduler.h"
+#include "player_views.h"
+#include "population_manager.h"
+#include "sharded_simulation.h"
+#include "spatial_index.h"
 #include "utils/direction.h"
+#include "utils/event_logger.h"
 #include "utils/info_deque.h"
+#include "utils/memory_tracker.h"
+#include "utils/zobrist_hash.h"
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -18,22 +32,92 @@ class Model {
 public:
   Model();
   void update();
+  // One tick with the monsters moving, whatever the time since the last
+  // one, for worlds driven by a search rather than by the clock
+  void step();
+  // Independent copy of the world for lookahead searches, deterministic
+  // as long as its own moves are
+  std::unique_ptr<Model> fork() const;
 
   void queuePlayerMove(const Point &point);
   void restart();
+  // The local player is dead, the others may still be playing
   bool isGameOver();
+  // Whether players other than the local one are alive in the dungeon
+  bool hasRemotePlayers() const;
   std::unordered_map<std::string, std::string> getPlayerStats();
+  // Living player closest to point, nullptr when everyone is dead
+  std::shared_ptr<Player> nearestPlayer(const Point &point) const;
+  // Hash of the map and of every living entity, equal worlds hash equally
+  uint64_t stateHash() const;
+  // The same hash computed from scratch, to check the incremental one
+  uint64_t computeStateHash() const;
 
-  std::shared_ptr<Player> player;
+  std::shared_ptr<Player> player; // the local player
+  PlayerList players; // local player first, then socket clients and bots
+  // Moves, joins and leaves of all players, applied at the start of update()
+  CommandBuffer commands;
+  // Surroundings of every socket client, published at the end of update()
+  PlayerViews views;
   std::shared_ptr<InfoDeque> info;
   std::shared_ptr<Map> map;
-  std::vector<std::shared_ptr<Monster>> monsters;
-  std::unordered_map<Point, std::shared_ptr<Treasure>> treasures;
+  FloorStack floors;       // floors as the party last left them, by depth
+  size_t currentFloor = 0; // 0 for the top floor
+  MonsterList monsters;
+  TreasureMap treasures;
+  SpatialIndex spatialIndex; // player, monsters and treasures by position
+  std::shared_ptr<PathScheduler> pathScheduler;
+  // Set when monsters are updated in parallel map strips (ShardWidth > 0)
+  std::unique_ptr<ShardedSimulation> shardedSimulation;
+  // Set when monsters steer around each other (CrowdSteering=1)
+  std::unique_ptr<CrowdSteering> crowdSteering;
+  // Brings the dead monsters of the floor back out of sight of the players
+  PopulationManager population;
 
 private:
-  void loadMap();
-  void fight(const std::shared_ptr<Monster> &monster);
-  void exploreTreasure(const std::shared_ptr<Treasure> &treasure);
+  Model(const Model &other); // deep copy behind fork()
+  Model &operator=(const Model &) = delete;
+
+  void tick(bool moveMonsters);
+  void logEvent(EventType type, int32_t arg0 = 0, int32_t arg1 = 0,
+                int32_t arg2 = 0);
+  void changeFloor(size_t target);
+  void generateFloor();
+  // Monsters and treasures placed by populateRows(), already on the map
+  // but not yet in the spatial index or the entity hash
+  struct Spawned {
+    MonsterList monsters;
+    std::vector<std::shared_ptr<Treasure>> treasures;
+  };
+  // Spawns the share of the configured counts that falls on rows
+  // [top, bottom), on cells carved already
+  Spawned populateRows(unsigned int top, unsigned int bottom);
+  void placePlayers(const Point &arrival);
+  void enterFloor();
+  void prefetchFloors();
+  void revealMaze();
+  void updateMonsters();
+  void updateMonstersSharded();
+  // Step of monsters[index] this tick, none when it waits
+  std::optional<Point> monsterStep(size_t index);
+  void checkStateHash();
+  void publishViews();
+  void publishView(const Player &viewer);
+  // Status line and the cells within viewRadius of viewer, as text
+  std::string viewOf(const Player &viewer) const;
+  void applyCommands();
+  void addPlayer(int id);
+  void removePlayer(int id);
+  void updateBots();
+  std::shared_ptr<Player> findPlayer(int id) const;
+  // Takes the stairs for the party: the local player while alive, then
+  // the first living remote player, nullptr when everyone is dead
+  std::shared_ptr<Player> partyLeader() const;
+  std::shared_ptr<Player> playerAt(const Point &point) const;
+  void fight(const std::shared_ptr<Monster> &monster,
+             const std::shared_ptr<Player> &player);
+  void exploreTreasure(const std::shared_ptr<Treasure> &treasure,
+                       const std::shared_ptr<Player> &player);
 
   void attemptPlayerMove(const std::shared_ptr<Player> &player,
                          const Point &direction);
@@ -44,11 +128,22 @@ private:
   bool isWall(const Point &point);
   bool isPlayer(const Point &point);
   bool isExit(const Point &point);
+  bool isEntrance(const Point &point); // stairs up, below the top floor
   bool isMonster(const Point &point);
   bool isTreasure(const Point &point);
   std::atomic_bool running;
-  std::queue<Point> playerMoves;
+  std::vector<int> bots; // player ids moved by updateBots()
   std::chrono::steady_clock::time_point lastUpdate;
+  uint64_t fightsThisTick = 0;
+  ZobristHash entityHash; // players, monsters and treasures on the map
+  bool stateHashCheck = false;
+  bool lazyMaze = false;       // floors carved as the players explore them
+  unsigned int lazyMazeMargin; // rows carved below the lowest player
+  int viewRadius;              // of the views sent to socket clients
+  // Draws of fights, treasures and bots, copied with the world so a fork
+  // plays out the same way every time
+  std::minstd_rand rng;
+  bool forked = false;
 };
 
 #endif // MODEL_H
@@ -0,0 +1,159 @@
+#include "path_scheduler.h"
+#include "utils/metrics.h"
+#include <algorithm>
+#include <utility>
+
+PathScheduler::PathScheduler(size_t _budgetPerTick, size_t _maxExpansions)
+    : budgetPerTick(_budgetPerTick), maxExpansions(_maxExpansions) {}
+
+PathScheduler::RequestId
+PathScheduler::request(std::shared_ptr<const Map> map, const Point &from,
+                       const Point &to, Navigable isNavigable,
+                       Callback onDone) {
+  static auto &unreachable = MetricsRegistry::getInstance().counter(
+      "md_path_requests_unreachable_total",
+      "Path searches skipped as the goal is walled off from the start");
+
+  std::deque<Point> waypoints;
+  if (auto rooms = map->getRoomGraph()) {
+    auto doors = rooms->route(from, to);
+    waypoints.assign(doors.begin(), doors.end());
+  }
+  waypoints.push_back(to);
+  auto search = std::make_unique<Search>(std::move(isNavigable));
+  if (map->isReachable(from, to)) {
+    search->begin(map->grid, from, waypoints.front());
+    waypoints.pop_front();
+  } else {
+    // Left idle, run() reports it as not found without expanding a node
+    unreachable.increment();
+    waypoints.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto id = nextId++;
+  requests.push_back({id, std::move(map), from, std::move(onDone),
+                      std::move(search), std::move(waypoints)});
+  return id;
+}
+
+void PathScheduler::cancel(RequestId id) {
+  std::lock_guard<std::mutex> lock(mutex);
+  requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                [id](const Request &request) {
+                                  return request.id == id;
+                                }),
+                 requests.end());
+}
+
+void PathScheduler::clear() {
+  // Callbacks may issue new requests, so they run on a detached list
+  std::vector<Request> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = std::move(requests);
+    requests.clear();
+  }
+  for (auto &request : cancelled) {
+    request.onDone({});
+  }
+}
+
+size_t PathScheduler::run(const Point &focus) {
+  static auto &expansionsPerTick = MetricsRegistry::getInstance().histogram(
+      "md_path_expansions_per_tick", "A* nodes expanded by the path scheduler "
+                                     "per tick");
+  static auto &pendingPaths = MetricsRegistry::getInstance().gauge(
+      "md_path_requests_pending", "Path searches waiting for budget");
+  static auto &abandoned = MetricsRegistry::getInstance().counter(
+      "md_path_requests_abandoned_total",
+      "Path searches stopped after reaching the expansion limit");
+
+  auto squaredDistance = [&focus](const Point &point) {
+    long dx = point.x - focus.x;
+    long dy = point.y - focus.y;
+    return dx * dx + dy * dy;
+  };
+  std::unique_lock<std::mutex> lock(mutex);
+  // Ties are broken by position, so the order does not depend on which
+  // thread issued its request first
+  std::stable_sort(requests.begin(), requests.end(),
+                   [&](const Request &a, const Request &b) {
+                     auto distanceA = squaredDistance(a.from);
+                     auto distanceB = squaredDistance(b.from);
+                     if (distanceA != distanceB) {
+                       return distanceA < distanceB;
+                     }
+                     return a.from.y != b.from.y ? a.from.y < b.from.y
+                                                 : a.from.x < b.from.x;
+                   });
+
+  size_t spent = 0;
+  std::vector<Request> finished;
+  for (auto &request : requests) {
+    if (spent >= budgetPerTick) {
+      break;
+    }
+    auto &search = *request.search;
+    auto status = Search::Status::SEARCHING;
+    while (status == Search::Status::SEARCHING && spent < budgetPerTick) {
+      auto before = search.getExpansions();
+      auto allowance = std::min(budgetPerTick - spent,
+                                maxExpansions - static_cast<size_t>(before));
+      status = search.step(allowance);
+      spent += search.getExpansions() - before;
+
+      if (status == Search::Status::SEARCHING &&
+          search.getExpansions() >= maxExpansions) {
+        abandoned.increment();
+        status = Search::Status::NOT_FOUND;
+      }
+      if (status == Search::Status::FOUND && !request.waypoints.empty()) {
+        // On to the next door, where this part of the path ends
+        appendPath(request.path, search.getPath());
+        search.begin(request.map->grid, request.path.back(),
+                     request.waypoints.front());
+        request.waypoints.pop_front();
+        status = Search::Status::SEARCHING;
+      }
+    }
+    if (status != Search::Status::SEARCHING) {
+      finished.push_back(std::move(request));
+    }
+  }
+
+  requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                [](const Request &request) {
+                                  return !request.search;
+                                }),
+                 requests.end());
+  auto stillPending = requests.size();
+  lock.unlock();
+
+  for (auto &request : finished) {
+    if (request.search->getStatus() == Search::Status::FOUND) {
+      appendPath(request.path, request.search->getPath());
+      request.onDone(std::move(request.path));
+    } else {
+      request.onDone({});
+    }
+  }
+
+  expansionsPerTick.record(spent);
+  pendingPaths.set(static_cast<int64_t>(stillPending));
+  return spent;
+}
+
+void PathScheduler::appendPath(Path &path, const Path &part) {
+  // Every part starts where the previous one ended
+  auto first = part.begin();
+  if (!path.empty() && first != part.end()) {
+    ++first;
+  }
+  path.insert(path.end(), first, part.end());
+}
+
+size_t PathScheduler::pending() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return requests.size();
+}
@@ -0,0 +1,77 @@
+#ifndef PATH_SCHEDULER_H
+#define PATH_SCHEDULER_H
+
+#include "algorithms/a_star.h"
+#include "map.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class PathScheduler {
+  /**
+   * @brief Runs A* searches a slice at a time under a shared budget.
+   * Every call to run() expands at most budgetPerTick nodes in total,
+   * spread over the pending searches in order of how close they start to
+   * the focus point (usually the player), so the tick time stays flat no
+   * matter how many monsters want a path. Searches that exceed
+   * maxExpansions are abandoned, which bounds the cost of unreachable
+   * goals. Finished searches report their path to the requester's callback,
+   * an empty path when no path was found.
+   * Requests may come from several simulation threads at once, the order
+   * they arrive in does not change the results.
+   * On levels made of rooms, a search between two rooms is split at the
+   * doors the room graph routes it through, so it only ever explores the
+   * rooms and corridors on the way instead of everything closer to the
+   * goal.
+   */
+public:
+  using Path = std::deque<Point>;
+  using Callback = std::function<void(Path)>;
+  using Navigable = std::function<bool(CellType)>;
+  using RequestId = uint64_t;
+
+  explicit PathScheduler(size_t budgetPerTick = 2000,
+                         size_t maxExpansions = 20000);
+
+  // The map is kept alive until the search finishes
+  RequestId request(std::shared_ptr<const Map> map, const Point &from,
+                    const Point &to, Navigable isNavigable, Callback onDone);
+  // Drops the search without calling its callback
+  void cancel(RequestId id);
+  // Completes every pending search with an empty path
+  void clear();
+
+  // Spends one tick of budget, returns the number of expanded nodes
+  size_t run(const Point &focus);
+
+  size_t pending() const;
+  size_t getBudgetPerTick() const { return budgetPerTick; }
+  size_t getMaxExpansions() const { return maxExpansions; }
+
+private:
+  using Search = AStar<CellType, Grid>;
+
+  struct Request {
+    RequestId id;
+    std::shared_ptr<const Map> map;
+    Point from;
+    Callback onDone;
+    std::unique_ptr<Search> search;
+    std::deque<Point> waypoints; // goals of the searches after this one
+    Path path;                   // found by the searches before
+  };
+
+  size_t budgetPerTick;
+  size_t maxExpansions;
+  RequestId nextId = 0;
+  std::vector<Request> requests;
+  mutable std::mutex mutex;
+
+  static void appendPath(Path &path, const Path &part);
+};
+
+#endif // PATH_SCHEDULER_H
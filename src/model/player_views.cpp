@@ -0,0 +1,27 @@
+#include "player_views.h"
+
+void PlayerViews::publish(int playerId, const std::string &view) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &current = views[playerId];
+  if (current.version == 0 || current.text != view) {
+    current.text = view;
+    ++current.version;
+  }
+}
+
+void PlayerViews::remove(int playerId) {
+  std::lock_guard<std::mutex> lock(mutex);
+  views.erase(playerId);
+}
+
+bool PlayerViews::takeNewer(int playerId, uint64_t &version,
+                            std::string &view) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = views.find(playerId);
+  if (found == views.end() || found->second.version <= version) {
+    return false;
+  }
+  version = found->second.version;
+  view = found->second.text;
+  return true;
+}
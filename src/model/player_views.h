@@ -0,0 +1,38 @@
+#ifndef PLAYER_VIEWS_H
+#define PLAYER_VIEWS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class PlayerViews {
+  /**
+   * @brief What every remote player sees, handed from the simulation to
+   * the player server.
+   * The simulation publishes a player's view at the end of each tick, the
+   * server sends it on its own thread whenever it is newer than the one
+   * the client got last. Only the latest view of a player is kept, so a
+   * slow client skips views instead of holding up the simulation or
+   * piling them up.
+   */
+public:
+  // Replaces the view of playerId, a view equal to the last one is not
+  // counted as newer
+  void publish(int playerId, const std::string &view);
+  void remove(int playerId);
+  // Copies the view of playerId into view when it is newer than version,
+  // and updates version to it
+  bool takeNewer(int playerId, uint64_t &version, std::string &view) const;
+
+private:
+  struct View {
+    uint64_t version = 0;
+    std::string text;
+  };
+
+  mutable std::mutex mutex;
+  std::unordered_map<int, View> views; // by player id
+};
+
+#endif // PLAYER_VIEWS_H
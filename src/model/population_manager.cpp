@@ -0,0 +1,180 @@
+#include "population_manager.h"
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+PopulationManager::PopulationManager(unsigned int _regionSize,
+                                     size_t _respawnBudget,
+                                     unsigned int _respawnPeriod,
+                                     double _viewDistance)
+    : regionSize(std::max(_regionSize, 1u)), respawnBudget(_respawnBudget),
+      respawnPeriod(std::max(_respawnPeriod, 1u)),
+      viewDistance(_viewDistance) {}
+
+PopulationManager::PopulationManager(const PopulationManager &other,
+                                     const MonsterWorld &world)
+    : regionSize(other.regionSize), respawnBudget(other.respawnBudget),
+      respawnPeriod(other.respawnPeriod), viewDistance(other.viewDistance),
+      columns(other.columns), rows(other.rows), targets(other.targets),
+      ticks(other.ticks), nextRegion(other.nextRegion) {
+  for (size_t kind = 0; kind < kindCount; ++kind) {
+    freeLists[kind].reserve(other.freeLists[kind].size());
+    for (const auto &monster : other.freeLists[kind]) {
+      freeLists[kind].push_back(monster->clone(world));
+    }
+  }
+}
+
+void PopulationManager::reset(unsigned int width, unsigned int height,
+                              const MonsterList &monsters) {
+  columns = (width + regionSize - 1) / regionSize;
+  rows = (height + regionSize - 1) / regionSize;
+  targets.assign(static_cast<size_t>(columns) * rows, Counts{});
+  for (const auto &monster : monsters) {
+    auto kind = kindOf(monster->cellType);
+    if (kind >= 0 && monster->isAlive()) {
+      ++targets[regionOf(monster->position)][kind];
+    }
+  }
+  for (auto &freeList : freeLists) {
+    freeList.clear();
+  }
+  ticks = 0;
+  nextRegion = 0;
+}
+
+void PopulationManager::adopt(const Monster &monster) {
+  auto kind = kindOf(monster.cellType);
+  if (kind >= 0 && !targets.empty()) {
+    ++targets[regionOf(monster.position)][kind];
+  }
+}
+
+void PopulationManager::release(std::shared_ptr<Monster> monster) {
+  auto kind = kindOf(monster->cellType);
+  if (kind >= 0) {
+    freeLists[kind].push_back(std::move(monster));
+  }
+}
+
+void PopulationManager::collect(MonsterList &monsters) {
+  auto dead = std::stable_partition(
+      monsters.begin(), monsters.end(),
+      [](const std::shared_ptr<Monster> &monster) {
+        return monster->isAlive();
+      });
+  for (auto monster = dead; monster != monsters.end(); ++monster) {
+    release(std::move(*monster));
+  }
+  monsters.erase(dead, monsters.end());
+}
+
+MonsterList PopulationManager::respawn(const Map &map,
+                                       const PlayerList &players,
+                                       MonsterList &monsters,
+                                       std::minstd_rand &random) {
+  MonsterList respawned;
+  if (++ticks % respawnPeriod != 0 || pooled() == 0 || targets.empty()) {
+    return respawned;
+  }
+
+  counts.assign(targets.size(), Counts{});
+  for (const auto &monster : monsters) {
+    auto kind = kindOf(monster->cellType);
+    if (kind >= 0 && monster->isAlive()) {
+      ++counts[regionOf(monster->position)][kind];
+    }
+  }
+
+  auto outOfView = [&](const Point &point) {
+    for (const auto &player : players) {
+      if (player->isAlive() &&
+          point.distance(player->position) <= viewDistance) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto findPosition =
+      [&](std::uniform_int_distribution<int> &randomX,
+          std::uniform_int_distribution<int> &randomY) -> std::optional<Point> {
+    for (int i = 0; i < placementAttempts; ++i) {
+      Point position(randomX(random), randomY(random));
+      // The map only learns of the monsters brought back afterwards
+      bool taken = std::any_of(
+          respawned.begin(), respawned.end(),
+          [&position](const std::shared_ptr<Monster> &monster) {
+            return monster->position == position;
+          });
+      if (!taken && map.isPositionFree(position) &&
+          map.isReachable(map.getStart(), position) && outOfView(position)) {
+        return position;
+      }
+    }
+    return std::nullopt;
+  };
+
+  // Regions take turns, so a small budget does not always go to the first
+  // ones short of monsters
+  size_t budget = respawnBudget;
+  for (size_t visited = 0; visited < targets.size() && budget > 0;
+       ++visited, nextRegion = (nextRegion + 1) % targets.size()) {
+    unsigned int left = (nextRegion % columns) * regionSize;
+    unsigned int top = (nextRegion / columns) * regionSize;
+    std::uniform_int_distribution<int> randomX(
+        left, std::min(left + regionSize, map.getWidth()) - 1);
+    std::uniform_int_distribution<int> randomY(
+        top, std::min(top + regionSize, map.getHeight()) - 1);
+    for (size_t kind = 0; kind < kindCount; ++kind) {
+      auto &count = counts[nextRegion][kind];
+      auto &freeList = freeLists[kind];
+      while (count < targets[nextRegion][kind] && !freeList.empty() &&
+             budget > 0) {
+        auto position = findPosition(randomX, randomY);
+        if (!position) {
+          break;
+        }
+        auto monster = std::move(freeList.back());
+        freeList.pop_back();
+        monster->revive(*position);
+        monsters.push_back(monster);
+        respawned.push_back(std::move(monster));
+        ++count;
+        --budget;
+      }
+    }
+  }
+  return respawned;
+}
+
+size_t PopulationManager::pooled() const {
+  size_t total = 0;
+  for (const auto &freeList : freeLists) {
+    total += freeList.size();
+  }
+  return total;
+}
+
+int PopulationManager::kindOf(CellType cellType) {
+  switch (cellType) {
+  case CellType::GOBLIN:
+    return 0;
+  case CellType::ORC:
+    return 1;
+  case CellType::TROLL:
+    return 2;
+  case CellType::DRAGON:
+    return 3;
+  default:
+    return -1;
+  }
+}
+
+size_t PopulationManager::regionOf(const Point &point) const {
+  auto column = std::min(static_cast<unsigned int>(point.x) / regionSize,
+                         columns - 1);
+  auto row = std::min(static_cast<unsigned int>(point.y) / regionSize,
+                      rows - 1);
+  return static_cast<size_t>(row) * columns + column;
+}
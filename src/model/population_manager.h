@@ -0,0 +1,78 @@
+#ifndef POPULATION_MANAGER_H
+#define POPULATION_MANAGER_H
+
+#include "entities/monster.h"
+#include "entities/player.h"
+#include "map.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+class PopulationManager {
+  /**
+   * @brief Keeps the monsters of a floor from dying out over a long game.
+   * The floor is cut into square regions, and the monsters of each kind
+   * standing in a region when the players enter the floor are its target.
+   * Dead monsters are kept on a free list of their kind instead of being
+   * freed. Every respawnPeriod monster ticks, regions short of their
+   * target get monsters back from the free lists, at most respawnBudget
+   * in total. They come back on free cells of the region that no player
+   * is within viewDistance of, so nobody sees them appear. As the dead
+   * are reused, a long game neither allocates monsters nor ends up with
+   * more of them to update than it started with.
+   */
+public:
+  static constexpr int placementAttempts = 8; // random cells per region
+
+  PopulationManager(unsigned int regionSize = 32, size_t respawnBudget = 2,
+                    unsigned int respawnPeriod = 20,
+                    double viewDistance = 15);
+  // Copy of other with its free lists cloned into world, for forks
+  PopulationManager(const PopulationManager &other, const MonsterWorld &world);
+  PopulationManager &operator=(const PopulationManager &) = delete;
+
+  // Takes the monsters of a floor as the targets of their regions and
+  // forgets the dead of the previous floor
+  void reset(unsigned int width, unsigned int height,
+             const MonsterList &monsters);
+  // Counts a monster placed after the floor was entered, e.g. in rows of
+  // a lazy maze carved since, towards the target of its region
+  void adopt(const Monster &monster);
+  // Keeps a dead monster for reuse
+  void release(std::shared_ptr<Monster> monster);
+  // Moves the dead out of monsters, onto the free lists
+  void collect(MonsterList &monsters);
+  // Brings dead monsters back where regions are short of their target and
+  // appends them to monsters. Returns the ones brought back, which still
+  // have to be put on the map
+  MonsterList respawn(const Map &map, const PlayerList &players,
+                      MonsterList &monsters, std::minstd_rand &random);
+
+  size_t pooled() const;
+  unsigned int getRegionSize() const { return regionSize; }
+
+private:
+  // Goblins, orcs, trolls and dragons
+  static constexpr size_t kindCount = 4;
+  using Counts = std::array<uint32_t, kindCount>;
+
+  static int kindOf(CellType cellType);
+  size_t regionOf(const Point &point) const;
+
+  unsigned int regionSize;
+  size_t respawnBudget;
+  unsigned int respawnPeriod;
+  double viewDistance;
+  unsigned int columns = 0;
+  unsigned int rows = 0;
+  std::vector<Counts> targets; // by region
+  std::vector<Counts> counts;  // living monsters by region, for respawn()
+  std::array<MonsterList, kindCount> freeLists;
+  unsigned int ticks = 0;
+  size_t nextRegion = 0; // first region served by the next respawn()
+};
+
+#endif // POPULATION_MANAGER_H
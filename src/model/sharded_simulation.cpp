@@ -0,0 +1,74 @@
+#include "sharded_simulation.h"
+#include "spatial_index.h"
+#include "utils/metrics.h"
+#include <algorithm>
+
+ShardedSimulation::ShardedSimulation(unsigned int _stripWidth,
+                                     unsigned int threadCount)
+    : stripWidth(std::max(1u, (_stripWidth + SpatialIndex::bucketSize - 1) /
+                                  SpatialIndex::bucketSize) *
+                 SpatialIndex::bucketSize),
+      pool(threadCount) {}
+
+size_t ShardedSimulation::stripOf(int x, size_t stripCount) const {
+  if (x < 0) {
+    return 0;
+  }
+  return std::min(static_cast<size_t>(x) / stripWidth, stripCount - 1);
+}
+
+void ShardedSimulation::tick(Map &map, const MonsterList &monsters,
+                             const LocalStep &localStep,
+                             const BorderStep &borderStep) {
+  static auto &borderMoves = MetricsRegistry::getInstance().counter(
+      "md_shard_border_moves_total",
+      "Monster moves handled at strip borders after the parallel phase");
+
+  auto stripCount = std::max<size_t>(
+      1, (map.getWidth() + stripWidth - 1) / stripWidth);
+  for (auto *lists : {&outboxes, &inboxes}) {
+    lists->resize(stripCount);
+    for (auto &list : *lists) {
+      list.clear();
+    }
+  }
+  residents.resize(stripCount);
+  stagedChanges.resize(stripCount);
+  for (size_t strip = 0; strip < stripCount; ++strip) {
+    residents[strip].clear();
+    stagedChanges[strip].clear();
+  }
+
+  for (size_t index = 0; index < monsters.size(); ++index) {
+    const auto &monster = monsters[index];
+    if (monster->isAlive()) {
+      residents[stripOf(monster->position.x, stripCount)].push_back(index);
+    }
+  }
+
+  pool.parallelFor(stripCount, [&](size_t strip) {
+    MapJournal::StagingScope staging(stagedChanges[strip]);
+    Strip bounds{static_cast<int>(strip * stripWidth),
+                 static_cast<int>((strip + 1) * stripWidth),
+                 static_cast<int>(map.getHeight())};
+    for (auto index : residents[strip]) {
+      if (auto target = localStep(index, bounds)) {
+        outboxes[strip].push_back({index, *target});
+      }
+    }
+  });
+
+  for (size_t strip = 0; strip < stripCount; ++strip) {
+    map.journal.append(stagedChanges[strip]);
+    for (const auto &message : outboxes[strip]) {
+      inboxes[stripOf(message.target.x, stripCount)].push_back(message);
+    }
+  }
+
+  for (const auto &inbox : inboxes) {
+    for (const auto &message : inbox) {
+      borderStep(monsters[message.monster], message.target);
+    }
+    borderMoves.increment(inbox.size());
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef SHARDED_SIMULATION_H
+#define SHARDED_SIMULATION_H
+
+#include "entities/monster.h"
+#include "map.h"
+#include "utils/worker_pool.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class ShardedSimulation {
+  /**
+   * @brief Ticks monsters in vertical map strips on worker threads.
+   * Each strip owns the monsters standing in it and updates them in list
+   * order. A monster may only touch cells of its own strip while the strips
+   * run in parallel; a move that leaves the strip, or needs state shared
+   * between strips, is posted to the inbox of the strip it targets. Inboxes
+   * are processed on the calling thread once all strips finished, in strip
+   * order, which also hands the monster over to its new strip.
+   * Strips have a fixed width, so the outcome of a tick depends on the
+   * strip width but not on the number of threads.
+   */
+public:
+  struct Strip {
+    int left;   // first column of the strip
+    int right;  // one past the last column
+    int height; // rows of the map
+
+    bool contains(const Point &point) const {
+      return point.x >= left && point.x < right && point.y >= 0 &&
+             point.y < height;
+    }
+  };
+
+  // Updates the monster at the given index of the list inside its strip,
+  // or returns the cell it wants to enter when that has to be handled in
+  // the border phase
+  using LocalStep =
+      std::function<std::optional<Point>(size_t, const Strip &)>;
+  using BorderStep =
+      std::function<void(const std::shared_ptr<Monster> &, const Point &)>;
+
+  // stripWidth is rounded up to whole spatial index buckets
+  ShardedSimulation(unsigned int stripWidth, unsigned int threadCount);
+
+  void tick(Map &map, const MonsterList &monsters, const LocalStep &localStep,
+            const BorderStep &borderStep);
+
+  unsigned int getStripWidth() const { return stripWidth; }
+  unsigned int getThreadCount() const { return pool.size(); }
+
+private:
+  struct Message {
+    size_t monster; // index into the monster list
+    Point target;
+  };
+
+  unsigned int stripWidth;
+  WorkerPool pool;
+
+  // Reused between ticks to avoid reallocating every tick
+  std::vector<std::vector<size_t>> residents; // indices into the list
+  std::vector<std::vector<Message>> outboxes;
+  std::vector<std::vector<Message>> inboxes;
+  std::vector<std::vector<CellChange>> stagedChanges;
+
+  size_t stripOf(int x, size_t stripCount) const;
+};
+
+#endif // SHARDED_SIMULATION_H
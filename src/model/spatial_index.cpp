@@ -0,0 +1,171 @@
+#include "spatial_index.h"
+#include <cmath>
+#include <queue>
+#include <utility>
+
+SpatialIndex::SpatialIndex(unsigned int width, unsigned int height) {
+  reset(width, height);
+}
+
+void SpatialIndex::reset(unsigned int _width, unsigned int _height) {
+  width = _width;
+  height = _height;
+  bucketsPerRow = (width + bucketSize - 1) / bucketSize;
+  bucketRows = (height + bucketSize - 1) / bucketSize;
+  count = 0;
+  buckets.clear();
+  buckets.resize(static_cast<size_t>(bucketsPerRow) * bucketRows);
+}
+
+SpatialIndex::Bucket &SpatialIndex::bucketAt(const Point &position) {
+  return buckets[(position.y / bucketSize) * bucketsPerRow +
+                 position.x / bucketSize];
+}
+
+void SpatialIndex::insert(Entity *entity) {
+  bucketAt(entity->position).push_back(entity);
+  ++count;
+}
+
+bool SpatialIndex::detach(Entity *entity, const Point &position) {
+  auto &bucket = bucketAt(position);
+  auto found = std::find(bucket.begin(), bucket.end(), entity);
+  if (found == bucket.end()) {
+    return false;
+  }
+  // Order inside a bucket does not matter, so swap with the last entry
+  *found = bucket.back();
+  bucket.pop_back();
+  return true;
+}
+
+void SpatialIndex::remove(Entity *entity, const Point &position) {
+  if (detach(entity, position)) {
+    --count;
+  }
+}
+
+void SpatialIndex::move(Entity *entity, const Point &from, const Point &to) {
+  // Only the two buckets are touched, so moves inside disjoint groups of
+  // buckets can run concurrently
+  if (&bucketAt(from) != &bucketAt(to) && detach(entity, from)) {
+    bucketAt(to).push_back(entity);
+  }
+}
+
+void SpatialIndex::copyFrom(
+    const SpatialIndex &other,
+    const std::function<Entity *(Entity *)> &counterpart) {
+  width = other.width;
+  height = other.height;
+  bucketsPerRow = other.bucketsPerRow;
+  bucketRows = other.bucketRows;
+  count = other.count;
+  buckets = other.buckets;
+  for (auto &bucket : buckets) {
+    for (auto &entity : bucket) {
+      entity = counterpart(entity);
+    }
+  }
+}
+
+std::vector<Entity *> SpatialIndex::queryRect(const Point &corner1,
+                                              const Point &corner2) const {
+  std::vector<Entity *> result;
+  forEachInRect(corner1, corner2,
+                [&result](Entity *entity) { result.push_back(entity); });
+  return result;
+}
+
+std::vector<Entity *> SpatialIndex::queryRadius(const Point &center,
+                                                double radius) const {
+  std::vector<Entity *> result;
+  if (radius < 0) {
+    return result;
+  }
+
+  int reach = static_cast<int>(std::floor(radius));
+  forEachInRect(center - Point(reach, reach), center + Point(reach, reach),
+                [&](Entity *entity) {
+                  if (entity->position.distance(center) <= radius) {
+                    result.push_back(entity);
+                  }
+                });
+  return result;
+}
+
+std::vector<Entity *>
+SpatialIndex::nearest(const Point &center, size_t k,
+                      const std::function<bool(const Entity &)> &accept) const {
+  if (k == 0 || buckets.empty()) {
+    return {};
+  }
+
+  auto squaredDistance = [&center](const Entity *entity) {
+    long dx = entity->position.x - center.x;
+    long dy = entity->position.y - center.y;
+    return dx * dx + dy * dy;
+  };
+
+  // Max-heap of the k best candidates found so far. Ties are broken by
+  // the order the entities were scanned in, never by their addresses, so
+  // a copy of the index answers the same whatever its allocations
+  struct Candidate {
+    long distance;
+    size_t scanned;
+    Entity *entity;
+    bool operator<(const Candidate &other) const {
+      return distance != other.distance ? distance < other.distance
+                                        : scanned < other.scanned;
+    }
+  };
+  std::priority_queue<Candidate> best;
+  size_t scanned = 0;
+
+  int centerX = std::clamp(center.x / bucketSize, 0, bucketsPerRow - 1);
+  int centerY = std::clamp(center.y / bucketSize, 0, bucketRows - 1);
+  int maxRing = std::max({centerX, bucketsPerRow - 1 - centerX, centerY,
+                          bucketRows - 1 - centerY});
+
+  for (int ring = 0; ring <= maxRing; ++ring) {
+    for (int by = centerY - ring; by <= centerY + ring; ++by) {
+      if (by < 0 || by >= bucketRows) {
+        continue;
+      }
+      // Inner rows of the ring only contribute their two edge buckets
+      bool edgeRow = by == centerY - ring || by == centerY + ring;
+      int step = edgeRow ? 1 : 2 * ring;
+      for (int bx = centerX - ring; bx <= centerX + ring;
+           bx += std::max(step, 1)) {
+        if (bx < 0 || bx >= bucketsPerRow) {
+          continue;
+        }
+        for (auto *entity : buckets[by * bucketsPerRow + bx]) {
+          if (accept && !accept(*entity)) {
+            continue;
+          }
+          Candidate candidate{squaredDistance(entity), scanned++, entity};
+          if (best.size() < k) {
+            best.push(candidate);
+          } else if (candidate < best.top()) {
+            best.pop();
+            best.push(candidate);
+          }
+        }
+      }
+    }
+
+    // Entities in the next ring are more than ring * bucketSize cells away
+    long bound = static_cast<long>(ring) * bucketSize;
+    if (best.size() == k && best.top().distance <= bound * bound) {
+      break;
+    }
+  }
+
+  std::vector<Entity *> result(best.size());
+  for (auto i = result.size(); i > 0; --i) {
+    result[i - 1] = best.top().entity;
+    best.pop();
+  }
+  return result;
+}
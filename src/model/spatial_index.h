@@ -0,0 +1,91 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "entities/entity.h"
+#include "utils/memory_tracker.h"
+#include "utils/point.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class SpatialIndex {
+  /**
+   * @brief Uniform grid of entity buckets for proximity queries.
+   * The map is split into 16x16 cell buckets, each holding the entities
+   * standing in it. Radius and rectangle queries only visit the buckets
+   * overlapping the query area, and k-nearest queries search rings of
+   * buckets outwards until no closer entity can exist.
+   * The index holds plain pointers, entities have to be removed before
+   * they are destroyed.
+   */
+public:
+  static constexpr int bucketSize = 16;
+
+  explicit SpatialIndex(unsigned int width = 0, unsigned int height = 0);
+
+  // Drops all entities and resizes the index for a map of the given size
+  void reset(unsigned int width, unsigned int height);
+
+  void insert(Entity *entity);
+  void remove(Entity *entity, const Point &position);
+  void move(Entity *entity, const Point &from, const Point &to);
+
+  // Takes over the buckets of another index with every entity replaced by
+  // counterpart(entity), keeping the order inside each bucket
+  void copyFrom(const SpatialIndex &other,
+                const std::function<Entity *(Entity *)> &counterpart);
+
+  // Entities inside the rectangle spanned by both corners, inclusive
+  std::vector<Entity *> queryRect(const Point &corner1,
+                                  const Point &corner2) const;
+  // Entities at most radius cells away from center (Euclidean distance)
+  std::vector<Entity *> queryRadius(const Point &center, double radius) const;
+  // Up to k accepted entities closest to center, nearest first
+  std::vector<Entity *>
+  nearest(const Point &center, size_t k,
+          const std::function<bool(const Entity &)> &accept = {}) const;
+
+  template <typename Callback>
+  void forEachInRect(const Point &corner1, const Point &corner2,
+                     Callback callback) const {
+    int left = std::max(std::min(corner1.x, corner2.x), 0);
+    int top = std::max(std::min(corner1.y, corner2.y), 0);
+    int right = std::min(std::max(corner1.x, corner2.x),
+                         static_cast<int>(width) - 1);
+    int bottom = std::min(std::max(corner1.y, corner2.y),
+                          static_cast<int>(height) - 1);
+    if (left > right || top > bottom) {
+      return;
+    }
+
+    for (int by = top / bucketSize; by <= bottom / bucketSize; ++by) {
+      for (int bx = left / bucketSize; bx <= right / bucketSize; ++bx) {
+        for (auto *entity : buckets[by * bucketsPerRow + bx]) {
+          const auto &p = entity->position;
+          if (p.x >= left && p.x <= right && p.y >= top && p.y <= bottom) {
+            callback(entity);
+          }
+        }
+      }
+    }
+  }
+
+  size_t size() const { return count; }
+
+private:
+  using Bucket =
+      std::vector<Entity *, TrackingAllocator<Entity *, MemoryTag::ENTITIES>>;
+
+  unsigned int width = 0;
+  unsigned int height = 0;
+  int bucketsPerRow = 0;
+  int bucketRows = 0;
+  size_t count = 0;
+  std::vector<Bucket, TrackingAllocator<Bucket, MemoryTag::ENTITIES>> buckets;
+
+  Bucket &bucketAt(const Point &position);
+  bool detach(Entity *entity, const Point &position);
+};
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,62 @@
+#include "board_pad.h"
+#include "game_board_renderer.h"
+#include "utils/metrics.h"
+
+BoardPad::~BoardPad() {
+  if (pad) {
+    delwin(pad);
+  }
+}
+
+bool BoardPad::update(const Grid &grid,
+                      const std::vector<Point> *changedCells) {
+  static auto &cellsDrawn = MetricsRegistry::getInstance().counter(
+      "md_board_cells_drawn_total", "Map cells drawn into the board pad");
+
+  if (static_cast<size_t>(grid.getWidth()) * grid.getHeight() > maxCells ||
+      grid.empty()) {
+    return false;
+  }
+
+  if (!pad || grid.getWidth() != width || grid.getHeight() != height) {
+    if (pad) {
+      delwin(pad);
+    }
+    width = grid.getWidth();
+    height = grid.getHeight();
+    pad = newpad(height, width);
+    changedCells = nullptr;
+    if (!pad) {
+      return false;
+    }
+  }
+
+  if (changedCells) {
+    for (const auto &point : *changedCells) {
+      drawCell(grid, point.x, point.y);
+    }
+    cellsDrawn.increment(changedCells->size());
+    return true;
+  }
+
+  for (unsigned int y = 0; y < height; ++y) {
+    for (unsigned int x = 0; x < width; ++x) {
+      drawCell(grid, x, y);
+    }
+  }
+  cellsDrawn.increment(static_cast<uint64_t>(width) * height);
+  return true;
+}
+
+void BoardPad::show(int top, int left, int height, int width) const {
+  if (height > 0 && width > 0) {
+    pnoutrefresh(pad, top, left, 0, 0, height - 1, width - 1);
+  }
+}
+
+void BoardPad::drawCell(const Grid &grid, int x, int y) {
+  const auto &[ch, color] = cellTypeToCharColor[grid.get(x, y)];
+  mvwaddch(pad, y, x,
+           static_cast<unsigned char>(ch) |
+               COLOR_PAIR(static_cast<int>(color)));
+}
@@ -0,0 +1,45 @@
+#ifndef BOARD_PAD_H
+#define BOARD_PAD_H
+
+#include "utils/grid.h"
+#include "utils/point.h"
+#include <cstddef>
+#include <ncurses.h>
+#include <vector>
+
+class BoardPad {
+  /**
+   * @brief ncurses pad holding the whole map.
+   * Cells are drawn into the pad once and afterwards only when they
+   * change, the viewport is a pnoutrefresh of the pad at the camera
+   * offset. Moving the camera therefore costs no drawing at all, ncurses
+   * only sends the cells that differ from what the terminal shows.
+   * Maps too large for a pad are left to the caller to draw directly.
+   */
+public:
+  // About 1024x1024 cells, larger pads take tens of megabytes
+  static constexpr size_t maxCells = 1 << 20;
+
+  BoardPad() = default;
+  ~BoardPad();
+
+  // Brings the pad in line with the grid, redrawing only changedCells when
+  // given and everything otherwise. Returns false if the grid is too large.
+  bool update(const Grid &grid, const std::vector<Point> *changedCells);
+
+  // Queues rows top.., columns left.. of the map for the next doupdate(),
+  // at the top left corner of the screen
+  void show(int top, int left, int height, int width) const;
+
+private:
+  WINDOW *pad = nullptr;
+  unsigned int width = 0;
+  unsigned int height = 0;
+
+  void drawCell(const Grid &grid, int x, int y);
+
+  BoardPad(BoardPad const &) = delete;
+  void operator=(BoardPad const &) = delete;
+};
+
+#endif // BOARD_PAD_H
@@ -36,28 +36,38 @@ std::unordered_map<CellType, std::pair<char, ColorPair>> cellTypeToCharColor = {
       ColorPair::TREASURE}},
 };
 
-GameBoardRenderer::GameBoardRenderer(const RendererData &_data) : data(_data) {
-  start_color(); // Start color functionality
-
-  // Define color pairs
-  std::unordered_map<ColorPair, std::pair<int, int>> colorDefinitions = {
-      {ColorPair::EMPTY, {COLOR_WHITE, COLOR_BLACK}},
-      {ColorPair::WALL, {COLOR_BLUE, COLOR_BLACK}},
-      {ColorPair::PLAYER, {COLOR_RED, COLOR_BLACK}},
-      {ColorPair::GOBLIN, {COLOR_GREEN, COLOR_BLACK}},
-      {ColorPair::ORC, {COLOR_CYAN, COLOR_BLACK}},
-      {ColorPair::DRAGON, {COLOR_YELLOW, COLOR_BLACK}},
-      {ColorPair::TROLL, {COLOR_MAGENTA, COLOR_BLACK}},
-      {ColorPair::START, {COLOR_GREEN, COLOR_BLACK}},
-      {ColorPair::END, {COLOR_RED, COLOR_WHITE}},
-      {ColorPair::TREASURE, {COLOR_CYAN, COLOR_BLACK}},
-  };
-
-  // Initialize color pairs
-  for (const auto &pair : colorDefinitions) {
-    init_pair(static_cast<int>(pair.first), pair.second.first,
-              pair.second.second);
-  }
+GameBoardRenderer::GameBoardRenderer(const RendererData &_data,
+                                     BoardWindows &_windows)
+    : data(_data), windows(_windows) {
+  // Renderers are created every frame, but the pairs are set up only once:
+  // ncurses repaints every cell of a pair whose colors are set again
+  static const bool colorsReady = []() {
+    start_color(); // Start color functionality
+
+    // Define color pairs
+    std::unordered_map<ColorPair, std::pair<int, int>> colorDefinitions = {
+        {ColorPair::EMPTY, {COLOR_WHITE, COLOR_BLACK}},
+        {ColorPair::WALL, {COLOR_BLUE, COLOR_BLACK}},
+        {ColorPair::PLAYER, {COLOR_RED, COLOR_BLACK}},
+        {ColorPair::GOBLIN, {COLOR_GREEN, COLOR_BLACK}},
+        {ColorPair::ORC, {COLOR_CYAN, COLOR_BLACK}},
+        {ColorPair::DRAGON, {COLOR_YELLOW, COLOR_BLACK}},
+        {ColorPair::TROLL, {COLOR_MAGENTA, COLOR_BLACK}},
+        {ColorPair::START, {COLOR_GREEN, COLOR_BLACK}},
+        {ColorPair::END, {COLOR_RED, COLOR_WHITE}},
+        {ColorPair::TREASURE, {COLOR_CYAN, COLOR_BLACK}},
+        {ColorPair::HEALTH_BAR, {COLOR_GREEN, COLOR_BLACK}},
+        {ColorPair::EXP_BAR, {COLOR_BLUE, COLOR_BLACK}},
+    };
+
+    // Initialize color pairs
+    for (const auto &pair : colorDefinitions) {
+      init_pair(static_cast<int>(pair.first), pair.second.first,
+                pair.second.second);
+    }
+    return true;
+  }();
+  (void)colorsReady;
 
   // Rectangels holding ratios
   auto getConfigRect = [](const std::string &leftKey, const std::string &topKey,
@@ -81,17 +91,36 @@ GameBoardRenderer::GameBoardRenderer(const RendererData &_data) : data(_data) {
 GameBoardRenderer::~GameBoardRenderer() {}
 
 void GameBoardRenderer::draw() {
-  clear();
+  getmaxyx(stdscr, termHeight, termWidth);
+
+  // Panels only send what changed, so they rely on the terminal still
+  // showing their last frame. Start from a blank screen when another
+  // screen, a resize or the debug overlay covered them.
+  if (windows.stale || windows.lines != termHeight ||
+      windows.columns != termWidth ||
+      (windows.overlayShown && !data.debugInfo)) {
+    erase();
+    wnoutrefresh(stdscr);
+    windows.messages.invalidate();
+    windows.stats.invalidate();
+    windows.stale = false;
+    windows.lines = termHeight;
+    windows.columns = termWidth;
+  }
+
   drawBoard();
   drawMessageDisplay();
   drawStats();
-  refresh();
+  if (data.debugInfo) {
+    drawDebugOverlay();
+  }
+  windows.overlayShown = data.debugInfo != nullptr;
+
+  // Everything queued above goes to the terminal in one write
+  doupdate();
 }
 
 void GameBoardRenderer::drawBoard() {
-
-  getmaxyx(stdscr, termHeight, termWidth);
-
   // Calculate board dimensions based on terminal size and grid size
   int gridRowSize = static_cast<int>(data.grid.size());
   int gridColSize = static_cast<int>(data.grid[0].size());
@@ -108,6 +137,12 @@ void GameBoardRenderer::drawBoard() {
                           std::min(gridColSize - boardWidth,
                                    data.playerPosition.x - boardWidth / 2));
 
+  // Panning the pad needs no drawing, only changed cells are redrawn
+  if (windows.board.update(data.grid, data.changedCells)) {
+    windows.board.show(viewTop, viewLeft, boardHeight, boardWidth);
+    return;
+  }
+
   // Render the game board based on the determined view
   for (int y = 0; y < boardHeight; ++y) {
     for (int x = 0; x < boardWidth; ++x) {
@@ -121,6 +156,7 @@ void GameBoardRenderer::drawBoard() {
       attroff(COLOR_PAIR(static_cast<int>(color)));
     }
   }
+  wnoutrefresh(stdscr);
 }
 
 void GameBoardRenderer::drawMessageDisplay() {
@@ -153,55 +189,72 @@ void GameBoardRenderer::drawMessageDisplay() {
     return result;
   };
 
-  getmaxyx(stdscr, termHeight, termWidth);
-
   int x = std::min(static_cast<int>(messageDisplayRect.right * termWidth),
                    static_cast<int>(data.grid[0].size()));
-  int y = static_cast<int>(messageDisplayRect.top * termHeight);
+  int top = static_cast<int>(messageDisplayRect.top * termHeight);
 
   int infoHeight =
       std::min(static_cast<int>(messageDisplayRect.bottom * termHeight), LINES);
 
+  // Lay the messages out first, the panel is only redrawn if they changed
+  std::vector<std::string> rows;
+  std::string content;
+  int maxRows = infoHeight - top;
   for (const auto &messgaes : data.messageQueue.reverse()) {
     for (const auto &info : messgaes) {
       // Prevent overflow if there are more fight info lines than screen rows
-      if (y >= infoHeight) {
+      if (static_cast<int>(rows.size()) >= maxRows) {
         break;
       }
       auto lines = splitStringToLines(
           info, COLS - x - 3); // Subtract 2 to account for the empty space
       for (const auto &line : lines) {
-        mvprintw(y++, x + 1, " %s",
-                 line.c_str()); // line + empty space
-        if (y >= infoHeight) {
+        rows.push_back("  " + line); // line + empty space
+        if (static_cast<int>(rows.size()) >= maxRows) {
           break;
         }
       }
     }
-    mvprintw(y++, x, " \n");
+    rows.emplace_back(); // empty line between groups of messages
+  }
+  for (const auto &row : rows) {
+    content += row + '\n';
   }
+
+  auto *window =
+      windows.messages.begin(top, x, maxRows, termWidth - x, content);
+  if (!window) {
+    return;
+  }
+  for (int y = 0; y < static_cast<int>(rows.size()) && y < maxRows; ++y) {
+    mvwaddnstr(window, y, 0, rows[y].c_str(), termWidth - x);
+  }
+  windows.messages.finish();
 }
 
 void GameBoardRenderer::drawStats() {
-  getmaxyx(stdscr, termHeight, termWidth);
-
-  // calculate positions based on statsRect
-  int yLevel = static_cast<int>(statsRect.top * termHeight) + 1;
+  // calculate positions based on statsRect, relative to the stats panel
+  int top = static_cast<int>(statsRect.top * termHeight);
+  int yLevel = 1;
   int yHealth = yLevel + 1;
   int yExp = yHealth + 1;
 
-  // initialize colors
-  start_color();
-  init_pair(1, COLOR_GREEN, COLOR_BLACK);
-  init_pair(2, COLOR_BLUE, COLOR_BLACK);
-
   int maxBarWidth = termWidth / 2;
   int labelWidth = 8;
 
+  auto content = data.stats["Level"] + ' ' + data.stats["Floor"] + ' ' +
+                 data.stats["Health"] + '/' + data.stats["MaxHealth"] + ' ' +
+                 data.stats["Experience"] + '/' + data.stats["MaxExp"];
+  auto *window = windows.stats.begin(
+      top, 0, std::min(yExp + 1, termHeight - top), maxBarWidth, content);
+  if (!window) {
+    return;
+  }
+
   auto drawProgressBar = [&](int y, const std::string &label, float percentage,
                              int color) {
     // draw label
-    mvprintw(y, 0, "%-*s", labelWidth,
+    mvwprintw(window, y, 0, "%-*s", labelWidth,
              (label + ": ")
                  .c_str()); // Left justify the label to a width of labelWidth
 
@@ -210,23 +263,62 @@ void GameBoardRenderer::drawStats() {
     int progress = static_cast<int>(progressBarWidth * percentage);
 
     // set color and draw progress
-    attron(COLOR_PAIR(color));
+    wattron(window, COLOR_PAIR(color));
     for (int i = 0; i < progress; i++) {
-      mvprintw(y, labelWidth + i, "=");
+      mvwprintw(window, y, labelWidth + i, "=");
     }
-    attroff(COLOR_PAIR(color));
+    wattroff(window, COLOR_PAIR(color));
   };
 
   // Print Level
-  mvprintw(yLevel, 0, " Level: %s", data.stats["Level"].c_str());
+  mvwprintw(window, yLevel, 0, " Level: %s  Floor: %s",
+            data.stats["Level"].c_str(), data.stats["Floor"].c_str());
 
   // Render Health
   float healthPercentage =
       stof(data.stats["Health"]) / stof(data.stats["MaxHealth"]);
-  drawProgressBar(yHealth, " Health", healthPercentage, 1); // 1 = COLOR_GREEN
+  drawProgressBar(yHealth, " Health", healthPercentage,
+                  static_cast<int>(ColorPair::HEALTH_BAR));
 
   // Render Experience
   float expPercentage =
       stof(data.stats["Experience"]) / stof(data.stats["MaxExp"]);
-  drawProgressBar(yExp, " Exp", expPercentage, 2); // 2 = COLOR_BLUE
+  drawProgressBar(yExp, " Exp", expPercentage,
+                  static_cast<int>(ColorPair::EXP_BAR));
+
+  windows.stats.finish();
+}
+
+void GameBoardRenderer::drawDebugOverlay() {
+  int overlayWidth = 0;
+  for (const auto &line : *data.debugInfo) {
+    overlayWidth = std::max(overlayWidth, static_cast<int>(line.size()));
+  }
+  overlayWidth = std::min(overlayWidth + 2, termWidth);
+
+  // Anchor the overlay in the top right corner of the terminal
+  int x = std::max(0, termWidth - overlayWidth);
+  int overlayHeight =
+      std::min(termHeight, static_cast<int>(data.debugInfo->size()));
+  if (overlayHeight <= 0 || overlayWidth <= 0) {
+    return;
+  }
+
+  // A window of its own, so the overlay stays on top of the board pad
+  WINDOW *overlay = newwin(overlayHeight, overlayWidth, 0, x);
+  if (!overlay) {
+    return;
+  }
+  int y = 0;
+  wattron(overlay, A_REVERSE);
+  for (const auto &line : *data.debugInfo) {
+    if (y >= overlayHeight) {
+      break;
+    }
+    mvwprintw(overlay, y++, 0, " %-*.*s", overlayWidth - 1, overlayWidth - 1,
+              line.c_str());
+  }
+  wattroff(overlay, A_REVERSE);
+  wnoutrefresh(overlay);
+  delwin(overlay);
 }
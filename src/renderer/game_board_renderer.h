@@ -1,6 +1,7 @@
 #ifndef GAME_BOARD_RENDERER_H
 #define GAME_BOARD_RENDERER_H
 
+#include "panel.h"
 #include "renderer_data.h"
 #include "state_renderer.h"
 
@@ -14,7 +15,9 @@ enum class ColorPair {
   TROLL,
   TREASURE,
   START,
-  END
+  END,
+  HEALTH_BAR,
+  EXP_BAR
 };
 extern std::unordered_map<CellType, std::pair<char, ColorPair>>
     cellTypeToCharColor;
@@ -32,7 +35,7 @@ struct Rect {
 
 class GameBoardRenderer : public StateRenderer {
 public:
-  GameBoardRenderer(const RendererData &_data);
+  GameBoardRenderer(const RendererData &_data, BoardWindows &_windows);
   ~GameBoardRenderer() override;
 
   void draw() override;
@@ -40,6 +43,7 @@ public:
 private:
   const RendererData
       &data; // Store a reference to the data needed for rendering
+  BoardWindows &windows; // outlive the per-frame renderers
 
   // Components' sizes
   Rect boardRect;
@@ -53,6 +57,7 @@ private:
   void drawBoard();
   void drawMessageDisplay();
   void drawStats();
+  void drawDebugOverlay();
 };
 
 #endif // GAME_BOARD_RENDERER_H
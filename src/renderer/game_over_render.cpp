@@ -3,13 +3,15 @@
 #include <ncurses.h>
 #include <string>
 
-GameOverRenderer::GameOverRenderer(const RendererData &_data) : data(_data) {}
+GameOverRenderer::GameOverRenderer(const RendererData &_data,
+                                   BoardWindows &_windows)
+    : data(_data), windows(_windows) {}
 GameOverRenderer::~GameOverRenderer() {}
 
 void GameOverRenderer::draw() {
   clear();
   std::unique_ptr<GameBoardRenderer> gameBoardRenderer =
-      std::make_unique<GameBoardRenderer>(data);
+      std::make_unique<GameBoardRenderer>(data, windows);
   gameBoardRenderer->draw(); // Draw the base game board first
   drawGameOver();            // Then draw "Game Over" on top
 }
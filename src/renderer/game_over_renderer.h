@@ -6,7 +6,7 @@
 
 class GameOverRenderer : public StateRenderer {
 public:
-  GameOverRenderer(const RendererData &_data);
+  GameOverRenderer(const RendererData &_data, BoardWindows &_windows);
   ~GameOverRenderer() override;
 
   void draw() override;
@@ -14,6 +14,7 @@ public:
 private:
   const RendererData
       &data; // Store a reference to the data needed for rendering
+  BoardWindows &windows;
 
   void drawGameOver();
 
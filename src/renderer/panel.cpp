@@ -0,0 +1,46 @@
+#include "panel.h"
+#include "utils/metrics.h"
+
+Panel::~Panel() {
+  if (window) {
+    delwin(window);
+  }
+}
+
+WINDOW *Panel::begin(int _top, int _left, int _height, int _width,
+                     const std::string &contentKey) {
+  if (_height <= 0 || _width <= 0) {
+    return nullptr;
+  }
+
+  if (!window || _top != top || _left != left || _height != height ||
+      _width != width) {
+    if (window) {
+      delwin(window);
+    }
+    top = _top;
+    left = _left;
+    height = _height;
+    width = _width;
+    window = newwin(height, width, top, left);
+    valid = false;
+    if (!window) {
+      return nullptr;
+    }
+  }
+
+  if (valid && contentKey == key) {
+    return nullptr;
+  }
+  key = contentKey;
+  valid = true;
+  werase(window);
+  return window;
+}
+
+void Panel::finish() {
+  static auto &refreshes = MetricsRegistry::getInstance().counter(
+      "md_panel_refreshes_total", "Screen panels sent to the terminal");
+  refreshes.increment();
+  wnoutrefresh(window);
+}
@@ -0,0 +1,54 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+#include "board_pad.h"
+#include <ncurses.h>
+#include <string>
+
+class Panel {
+  /**
+   * @brief ncurses window for one part of the screen.
+   * The caller describes what the panel should show with a content key
+   * (e.g. the text of its lines). The window is redrawn and queued for the
+   * next doupdate() only when the key or the geometry differs from the
+   * previous frame, so an unchanged panel costs nothing and a changed one
+   * does not drag the rest of the screen along.
+   */
+public:
+  Panel() = default;
+  ~Panel();
+
+  // Window to draw into, cleared, or nullptr when the panel is unchanged
+  WINDOW *begin(int top, int left, int height, int width,
+                const std::string &contentKey);
+  // Queues the window returned by begin() for the next doupdate()
+  void finish();
+  // Redraws on the next begin(), e.g. after something covered the panel
+  void invalidate() { valid = false; }
+
+private:
+  WINDOW *window = nullptr;
+  int top = 0;
+  int left = 0;
+  int height = 0;
+  int width = 0;
+  std::string key;
+  bool valid = false;
+
+  Panel(Panel const &) = delete;
+  void operator=(Panel const &) = delete;
+};
+
+// Windows of the game board screen, kept between the per-frame renderers
+struct BoardWindows {
+  BoardPad board;
+  Panel messages;
+  Panel stats;
+  // Screen size of the previous frame
+  int lines = 0;
+  int columns = 0;
+  bool overlayShown = false; // the debug overlay covered the panels
+  bool stale = true;         // another screen was drawn since the last frame
+};
+
+#endif // PANEL_H
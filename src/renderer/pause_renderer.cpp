@@ -0,0 +1,33 @@
+#include "pause_renderer.h"
+#include "utils/global_config.h"
+#include <ncurses.h>
+#include <string>
+
+PauseRenderer::PauseRenderer(const RendererData &_data,
+                             BoardWindows &_windows)
+    : data(_data), windows(_windows) {}
+
+void PauseRenderer::draw() {
+  clear();
+  GameBoardRenderer(data, windows).draw(); // the board stays behind
+  drawPaused();
+}
+
+void PauseRenderer::drawPaused() {
+  int termHeight, termWidth;
+  getmaxyx(stdscr, termHeight, termWidth);
+  const std::string paused = "Paused, press p to resume";
+
+  // Centred on the board, like "Game Over"
+  int xPos = (termWidth * GlobalConfig::getInstance().getConfig<double>(
+                              "BoardRectRight") -
+              paused.length()) /
+             2;
+  int yPos = (termHeight * GlobalConfig::getInstance().getConfig<double>(
+                               "BoardRectBottom")) /
+             2;
+
+  attron(A_BOLD);
+  mvprintw(yPos, xPos, "%s", paused.c_str());
+  attroff(A_BOLD);
+}
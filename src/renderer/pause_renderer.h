@@ -0,0 +1,19 @@
+#ifndef PAUSE_RENDERER_H
+#define PAUSE_RENDERER_H
+
+#include "game_board_renderer.h"
+
+class PauseRenderer : public StateRenderer {
+public:
+  PauseRenderer(const RendererData &_data, BoardWindows &_windows);
+
+  void draw() override;
+
+private:
+  const RendererData &data;
+  BoardWindows &windows;
+
+  void drawPaused();
+};
+
+#endif // PAUSE_RENDERER_H
@@ -1,46 +1,110 @@
 #include "renderer.h"
 #include "game_over_renderer.h"
 #include "main_menu_renderer.h"
+#include "pause_renderer.h"
+#include "utils/metrics.h"
+#include "utils/profiler.h"
 #include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+// Bytes the thread that opened ioFile passed to write() so far, as
+// accounted by the kernel, or -1 when per-thread I/O accounting is not
+// available. ncurses has no output hook, but it is the only writer on the
+// render thread, so the difference between two frames is what was sent to
+// the terminal. The file stays open and is read again from the start.
+long long threadBytesWritten(int ioFile) {
+  if (ioFile < 0) {
+    return -1;
+  }
+  char text[512];
+  auto length = pread(ioFile, text, sizeof(text) - 1, 0);
+  if (length <= 0) {
+    return -1;
+  }
+  text[length] = '\0';
+  const char *found = std::strstr(text, "wchar:");
+  return found ? std::strtoll(found + 6, nullptr, 10) : -1;
+}
+} // namespace
 
 Renderer::Renderer() {
   initscr(); // Call initscr() to initialize the library
   noecho();
   curs_set(0);
+  ioFile = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+  boardWindows = std::make_shared<BoardWindows>();
 
   stateRendererMap[GameState::MAIN_MENU] = [](const RendererData &) {
     return std::make_unique<MainMenuRenderer>();
   };
-  stateRendererMap[GameState::GAMEPLAY] = [](const RendererData &data) {
-    return std::make_unique<GameBoardRenderer>(data);
-  };
-  stateRendererMap[GameState::GAME_OVER] = [](const RendererData &data) {
-    return std::make_unique<GameOverRenderer>(data);
-  };
+  stateRendererMap[GameState::GAMEPLAY] =
+      [windows = boardWindows](const RendererData &data) {
+        return std::make_unique<GameBoardRenderer>(data, *windows);
+      };
+  stateRendererMap[GameState::PAUSE_MENU] =
+      [windows = boardWindows](const RendererData &data) {
+        return std::make_unique<PauseRenderer>(data, *windows);
+      };
+  stateRendererMap[GameState::GAME_OVER] =
+      [windows = boardWindows](const RendererData &data) {
+        return std::make_unique<GameOverRenderer>(data, *windows);
+      };
   // ... other game states
 }
 
 Renderer::Renderer(const Renderer &other)
     : currentGameState(other.currentGameState),
+      boardWindows(other.boardWindows),
       stateRendererMap(other.stateRendererMap) {
   initscr();
   noecho();
   curs_set(0);
+  ioFile = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
 }
 
 Renderer::~Renderer() {
+  if (ioFile >= 0) {
+    close(ioFile);
+  }
   endwin();
   std::system("clear");
   exit(0);
 }
 
-void Renderer::setState(GameState gameState) { currentGameState = gameState; }
+void Renderer::setState(GameState gameState) {
+  if (gameState != currentGameState) {
+    // The new screen draws over the board panels
+    boardWindows->stale = true;
+  }
+  currentGameState = gameState;
+}
 
 void Renderer::draw(const RendererData &data) {
   if (!stateRendererMap.count(currentGameState)) {
     return;
   }
 
+  static auto &frames = MetricsRegistry::getInstance().counter(
+      "md_frames_drawn_total", "Number of frames drawn");
+  static auto &frameDuration = MetricsRegistry::getInstance().histogram(
+      "md_frame_duration_seconds", "Time spent drawing a frame", 1e-9);
+  static auto &bytesWritten = MetricsRegistry::getInstance().counter(
+      "md_terminal_bytes_written_total", "Bytes written to the terminal");
+  // Read once a frame and outside of the timed part: what the last frame
+  // wrote is the difference with the reading before it
+  auto written = threadBytesWritten(ioFile);
+  if (lastBytesWritten >= 0 && written > lastBytesWritten) {
+    bytesWritten.increment(written - lastBytesWritten);
+  }
+  lastBytesWritten = written;
+
+  Profiler::PhaseScope phase(ProfilePhase::RENDER);
+  ScopedTimer timer(frameDuration);
+  frames.increment();
+
   std::unique_ptr<StateRenderer> currentStateRenderer =
       stateRendererMap[currentGameState](data);
   currentStateRenderer->draw();
@@ -1,6 +1,7 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "panel.h"
 #include "renderer_data.h"
 #include "state_renderer.h"
 #include "utils/game_settings.h"
@@ -22,10 +23,15 @@ public:
   void setState(GameState gameState);
 
 private:
-  GameState currentGameState;
+  GameState currentGameState = GameState::MAIN_MENU;
+  // Shared by the gameplay and game over renderers, kept between frames
+  std::shared_ptr<BoardWindows> boardWindows;
   std::map<GameState,
            std::function<std::unique_ptr<StateRenderer>(const RendererData &)>>
       stateRendererMap;
+  // /proc/thread-self/io of the drawing thread, for the bytes it wrote
+  int ioFile = -1;
+  long long lastBytesWritten = -1;
 };
 
 #endif // RENDERER_H
@@ -2,6 +2,7 @@
 #define _RENDERER_DATA_H
 
 #include "utils/game_settings.h"
+#include "utils/grid.h"
 #include "utils/info_deque.h"
 #include "utils/point.h"
 #include <string>
@@ -13,12 +14,17 @@ struct RendererData {
 RendererData holds references to the original objects, so changes to the objects
 in RendererData will affect the original objects, and vice versa.
 */
-  std::vector<std::vector<CellType>> &grid;
+  Grid &grid;
   InfoDeque &messageQueue;
   std::unordered_map<std::string, std::string> &stats;
   Point &playerPosition;
+  // Optional lines shown in the debug overlay, nullptr when it is hidden
+  const std::vector<std::string> *debugInfo = nullptr;
+  // Cells changed since the previous frame, nullptr when any cell may have
+  // changed (new level, first frame)
+  const std::vector<Point> *changedCells = nullptr;
 
-  RendererData(std::vector<std::vector<CellType>> &_grid,
+  RendererData(Grid &_grid,
                InfoDeque &_messageQueue,
                std::unordered_map<std::string, std::string> &_stats,
                Point &_playerPosition
@@ -3,6 +3,8 @@
 
 #include "renderer_data.h"
 #include "utils/game_settings.h"
+#include "utils/memory_tracker.h"
+#include <new>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,6 +14,17 @@ public:
   virtual ~StateRenderer() = default; // Ensure we have a virtual destructor
 
   virtual void draw() = 0; // Pure virtual function
+
+  // State renderers are created per frame, account them to the renderer
+  static void *operator new(std::size_t size) {
+    MemoryTracker::getInstance().recordAllocation(MemoryTag::RENDERER, size);
+    return ::operator new(size);
+  }
+
+  static void operator delete(void *ptr, std::size_t size) {
+    MemoryTracker::getInstance().recordDeallocation(MemoryTag::RENDERER, size);
+    ::operator delete(ptr);
+  }
 };
 
 #endif // STATE_RENDERER_H
@@ -0,0 +1,221 @@
+#include "event_logger.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+
+namespace {
+const char eventLogMagic[8] = {'M', 'D', 'E', 'V', 'L', 'O', 'G', '\0'};
+const uint32_t eventLogVersion = 1;
+
+// Names of the record arguments for each event type, nullptr when unused
+const char *eventArgNames[][4] = {
+    {"pid", nullptr, nullptr, nullptr},       // LOGGER_STARTED
+    {"count", "thread", nullptr, nullptr},    // EVENTS_DROPPED
+    {"from", "to", nullptr, nullptr},         // STATE_CHANGED
+    {"width", "height", "floor", nullptr},    // LEVEL_LOADED
+    {"x", "y", nullptr, nullptr},             // PLAYER_MOVED
+    {"monster", "x", "y", nullptr},           // FIGHT_STARTED
+    {"entity", "x", "y", nullptr},            // ENTITY_DEFEATED
+    {"bonusType", "bonus", nullptr, nullptr}, // TREASURE_EXPLORED
+    {"length", "x", "y", nullptr},            // PATH_COMPUTED
+    {"error", nullptr, nullptr, nullptr},     // PATHFINDING_ERROR
+    {"low", "high", "tick", nullptr},         // STATE_HASH
+    {"entity", "x", "y", nullptr},            // ENTITY_SPAWNED
+};
+
+static_assert(sizeof(eventArgNames) / sizeof(eventArgNames[0]) ==
+                  static_cast<size_t>(EventType::COUNT),
+              "Every event type needs argument names");
+} // namespace
+
+EventLogger::ThreadBufferHandle::~ThreadBufferHandle() {
+  if (buffer) {
+    buffer->retired.store(true, std::memory_order_release);
+  }
+}
+
+EventLogger::~EventLogger() { stop(); }
+
+bool EventLogger::start(const std::string &path,
+                        std::chrono::milliseconds flushInterval) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (running) {
+    return true;
+  }
+
+  file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  startTime = std::chrono::steady_clock::now();
+  interval = flushInterval;
+
+  EventLogHeader header{};
+  std::memcpy(header.magic, eventLogMagic, sizeof(header.magic));
+  header.version = eventLogVersion;
+  header.recordSize = sizeof(EventRecord);
+  header.startTime = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  std::fwrite(&header, sizeof(header), 1, file);
+
+  running = true;
+  writer = std::thread(&EventLogger::writeLoop, this);
+  lock.unlock();
+
+  log(EventType::LOGGER_STARTED, static_cast<int32_t>(getpid()));
+  return true;
+}
+
+void EventLogger::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running) {
+      return;
+    }
+    running = false;
+  }
+  wakeUp.notify_one();
+
+  if (writer.joinable()) {
+    writer.join();
+  }
+
+  drain();
+  std::fclose(file);
+  file = nullptr;
+}
+
+EventLogger::ThreadBuffer &EventLogger::threadBuffer() {
+  thread_local ThreadBufferHandle handle;
+  if (!handle.buffer) {
+    handle.buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(mutex);
+    handle.buffer->threadId = nextThreadId++;
+    buffers.push_back(handle.buffer);
+  }
+  return *handle.buffer;
+}
+
+void EventLogger::writeLoop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (running) {
+    wakeUp.wait_for(lock, interval);
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+}
+
+void EventLogger::drain() {
+  std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshot = buffers;
+  }
+
+  for (const auto &buffer : snapshot) {
+    auto tail = buffer->tail.load(std::memory_order_relaxed);
+    auto head = buffer->head.load(std::memory_order_acquire);
+
+    while (tail != head) {
+      // Write the contiguous part up to the end of the ring at once
+      auto index = tail & (bufferCapacity - 1);
+      auto count = std::min(head - tail, bufferCapacity - index);
+      std::fwrite(&buffer->records[index], sizeof(EventRecord), count, file);
+      tail += count;
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+
+    if (auto dropped = buffer->dropped.exchange(0)) {
+      EventRecord record{};
+      record.timestamp = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - startTime)
+              .count());
+      record.threadId = buffer->threadId;
+      record.type = static_cast<uint16_t>(EventType::EVENTS_DROPPED);
+      record.args[0] = static_cast<int32_t>(
+          std::min<uint64_t>(dropped, std::numeric_limits<int32_t>::max()));
+      record.args[1] = static_cast<int32_t>(buffer->threadId);
+      std::fwrite(&record, sizeof(record), 1, file);
+    }
+  }
+  std::fflush(file);
+
+  // Buffers of finished threads can go once everything they held is written
+  std::lock_guard<std::mutex> lock(mutex);
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                               [](const std::shared_ptr<ThreadBuffer> &buffer) {
+                                 return buffer->retired &&
+                                        buffer->tail == buffer->head;
+                               }),
+                buffers.end());
+}
+
+std::string EventLogger::eventTypeName(EventType type) {
+  switch (type) {
+  case EventType::LOGGER_STARTED:
+    return "LOGGER_STARTED";
+  case EventType::EVENTS_DROPPED:
+    return "EVENTS_DROPPED";
+  case EventType::STATE_CHANGED:
+    return "STATE_CHANGED";
+  case EventType::LEVEL_LOADED:
+    return "LEVEL_LOADED";
+  case EventType::PLAYER_MOVED:
+    return "PLAYER_MOVED";
+  case EventType::FIGHT_STARTED:
+    return "FIGHT_STARTED";
+  case EventType::ENTITY_DEFEATED:
+    return "ENTITY_DEFEATED";
+  case EventType::TREASURE_EXPLORED:
+    return "TREASURE_EXPLORED";
+  case EventType::PATH_COMPUTED:
+    return "PATH_COMPUTED";
+  case EventType::PATHFINDING_ERROR:
+    return "PATHFINDING_ERROR";
+  case EventType::STATE_HASH:
+    return "STATE_HASH";
+  case EventType::ENTITY_SPAWNED:
+    return "ENTITY_SPAWNED";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+bool EventLogger::decode(std::istream &in, std::ostream &out) {
+  EventLogHeader header{};
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, eventLogMagic, sizeof(header.magic)) != 0 ||
+      header.version != eventLogVersion ||
+      header.recordSize != sizeof(EventRecord)) {
+    return false;
+  }
+
+  EventRecord record{};
+  char line[256];
+  while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    auto type = static_cast<EventType>(record.type);
+    int length = std::snprintf(
+        line, sizeof(line), "%14.6f ms  t%-3" PRIu32 " %s",
+        record.timestamp / 1e6, record.threadId, eventTypeName(type).c_str());
+
+    if (record.type < static_cast<uint16_t>(EventType::COUNT)) {
+      for (int i = 0; i < 4; ++i) {
+        const char *name = eventArgNames[record.type][i];
+        if (name && length < static_cast<int>(sizeof(line))) {
+          length += std::snprintf(line + length, sizeof(line) - length,
+                                  " %s=%" PRId32, name, record.args[i]);
+        }
+      }
+    }
+    out << line << '\n';
+  }
+
+  return true;
+}
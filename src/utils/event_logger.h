@@ -0,0 +1,143 @@
+#ifndef EVENT_LOGGER_H
+#define EVENT_LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class EventType : uint16_t {
+  LOGGER_STARTED,
+  EVENTS_DROPPED,
+  STATE_CHANGED,
+  LEVEL_LOADED,
+  PLAYER_MOVED,
+  FIGHT_STARTED,
+  ENTITY_DEFEATED,
+  TREASURE_EXPLORED,
+  PATH_COMPUTED,
+  PATHFINDING_ERROR,
+  STATE_HASH,
+  ENTITY_SPAWNED,
+  COUNT
+};
+
+struct EventRecord {
+  /**
+   * @brief Fixed-size binary record, written as is to the event log.
+   */
+  uint64_t timestamp; // nanoseconds since the logger was started
+  uint32_t threadId;
+  uint16_t type;
+  uint16_t reserved;
+  int32_t args[4];
+};
+
+static_assert(sizeof(EventRecord) == 32, "EventRecord must stay 32 bytes");
+
+struct EventLogHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint64_t startTime; // system clock, nanoseconds since epoch
+};
+
+class EventLogger {
+  /**
+   * @brief Asynchronous binary event logger.
+   * Every thread writes into its own single-producer ring buffer, a
+   * background thread drains the buffers to the log file. When a buffer is
+   * full the event is dropped and counted rather than blocking the caller.
+   */
+public:
+  static constexpr size_t bufferCapacity = 1 << 14;
+
+  static EventLogger &getInstance() {
+    static EventLogger instance;
+    return instance;
+  }
+
+  bool start(const std::string &path,
+             std::chrono::milliseconds flushInterval =
+                 std::chrono::milliseconds(100));
+  void stop();
+  bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+  void log(EventType type, int32_t arg0 = 0, int32_t arg1 = 0,
+           int32_t arg2 = 0, int32_t arg3 = 0) {
+    if (!running.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    auto &buffer = threadBuffer();
+    auto head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= bufferCapacity) {
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    auto &record = buffer.records[head & (bufferCapacity - 1)];
+    record.timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime)
+            .count());
+    record.threadId = buffer.threadId;
+    record.type = static_cast<uint16_t>(type);
+    record.reserved = 0;
+    record.args[0] = arg0;
+    record.args[1] = arg1;
+    record.args[2] = arg2;
+    record.args[3] = arg3;
+    buffer.head.store(head + 1, std::memory_order_release);
+  }
+
+  static std::string eventTypeName(EventType type);
+
+  // Renders a binary event log as text, one event per line.
+  static bool decode(std::istream &in, std::ostream &out);
+
+  ~EventLogger();
+
+private:
+  struct ThreadBuffer {
+    std::array<EventRecord, bufferCapacity> records;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+    uint32_t threadId = 0;
+  };
+
+  struct ThreadBufferHandle {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadBufferHandle();
+  };
+
+  std::atomic_bool running{false};
+  std::chrono::steady_clock::time_point startTime;
+  std::chrono::milliseconds interval{100};
+  std::FILE *file = nullptr;
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  uint32_t nextThreadId = 0;
+
+  ThreadBuffer &threadBuffer();
+  void writeLoop();
+  void drain();
+
+  EventLogger() = default;
+  EventLogger(EventLogger const &) = delete;
+  void operator=(EventLogger const &) = delete;
+};
+
+#endif // EVENT_LOGGER_H
@@ -1,7 +1,10 @@
 #ifndef GAME_SETTINGS_H
 #define GAME_SETTINGS_H
 
-enum class CellType {
+#include <cstdint>
+
+// Values must stay below 16, packed grids store a cell in 4 bits
+enum class CellType : uint8_t {
   EMPTY = 0,
   WALL,
   PLAYER,
@@ -6,6 +6,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 class GlobalConfig {
 public:
@@ -27,6 +28,16 @@ public:
     throw std::runtime_error("Key not found");
   }
 
+  // Same as above, but falls back to defaultValue when the key is missing,
+  // so config files written by older versions keep working.
+  template <typename T>
+  T getConfig(const std::string &key, const T &defaultValue) {
+    if (config.find(key) == config.end()) {
+      return defaultValue;
+    }
+    return getConfig<T>(key);
+  }
+
 private:
   std::map<std::string, std::string> config;
 
@@ -66,15 +77,19 @@ private:
                                                   "PlayerHealth=300",
                                                   "PlayerDamage=100",
                                                   "MonsterUpdateSpeed=360",
+                                                  "GoblinsSpacing=4",
                                                   "GoblinsCount=50",
                                                   "GoblinHealth=100",
                                                   "GoblinDamage=30",
+                                                  "OrcsSpacing=6",
                                                   "OrcsCount=20",
                                                   "OrcHealth=200",
                                                   "OrcDamage=30",
+                                                  "TrollsSpacing=6",
                                                   "TrollsCount=10",
                                                   "TrollHealth=300",
                                                   "TrollDamage=50",
+                                                  "DragonsSpacing=10",
                                                   "DragonsCount=10",
                                                   "DragonHealth=400",
                                                   "DragonDamage=100",
@@ -89,11 +104,41 @@ private:
                                                   "StartSymbol=S",
                                                   "EndSymbol=❎",
                                                   "TreasureSymbol=*",
+                                                  "TreasureCount=20",
+                                                  "TreasureSpacing=5",
                                                   "BonusValue=50",
-                                                  "BonusExpirationCounter=100"};
+                                                  "BonusExpirationCounter=100",
+                                                  "EventLogging=0",
+                                                  "EventLogPath=events.bin",
+                                                  "MetricsExport=0",
+                                                  "MetricsExportPath=metrics.prom",
+                                                  "MetricsExportIntervalMs=5000",
+                                                  "PathBudgetPerTick=2000",
+                                                  "PathMaxExpansions=20000",
+                                                  "ShardWidth=0",
+                                                  "SimulationThreads=0",
+                                                  "BotCount=0",
+                                                  "MaxPendingMoves=8",
+                                                  "PlayerViewRadius=7",
+                                                  "StateHashCheck=0",
+                                                  "LevelSeed=0",
+                                                  "MazeAlgorithm=dfs",
+                                                  "LevelCacheSize=16",
+                                                  "LazyMaze=0",
+                                                  "LazyMazeMargin=40",
+                                                  "RespawnRegionSize=32",
+                                                  "RespawnBudget=2",
+                                                  "RespawnPeriod=20",
+                                                  "RespawnViewDistance=15",
+                                                  "CrowdSteering=0",
+                                                  "CrowdSeparation=1.0",
+                                                  "CrowdAlignment=0.5"};
 
         for (const auto &entry : defaultConfig) {
           newConfigFile << entry << "\n";
+          // The defaults also apply to this run, not only to the next one
+          auto separator = entry.find('=');
+          config[entry.substr(0, separator)] = entry.substr(separator + 1);
         }
 
         newConfigFile.close();
@@ -0,0 +1,66 @@
+#include "grid.h"
+#include <algorithm>
+
+GridLayout parseGridLayout(const std::string &name) {
+  if (name == "tiled") {
+    return GridLayout::TILED;
+  }
+  if (name == "morton") {
+    return GridLayout::MORTON;
+  }
+  return GridLayout::ROW_MAJOR;
+}
+
+std::string gridLayoutName(GridLayout layout) {
+  switch (layout) {
+  case GridLayout::TILED:
+    return "tiled";
+  case GridLayout::MORTON:
+    return "morton";
+  default:
+    return "row";
+  }
+}
+
+GridStorage parseGridStorage(const std::string &name) {
+  return name == "packed" ? GridStorage::PACKED : GridStorage::BYTE;
+}
+
+std::string gridStorageName(GridStorage storage) {
+  return storage == GridStorage::PACKED ? "packed" : "byte";
+}
+
+Grid::Grid(unsigned int width, unsigned int height, GridLayout layout,
+           GridStorage storage, CellType value)
+    : width(width), height(height), layout(layout), storage(storage) {
+  // Partial blocks at the right and bottom edges are padded to full blocks
+  auto blocks = [](unsigned int size, unsigned int blockSize) {
+    return static_cast<size_t>((size + blockSize - 1) / blockSize);
+  };
+
+  switch (layout) {
+  case GridLayout::TILED:
+    blocksPerRow = blocks(width, 8);
+    cellCount = blocksPerRow * blocks(height, 8) * 64;
+    break;
+  case GridLayout::MORTON:
+    blocksPerRow = blocks(width, 64);
+    cellCount = blocksPerRow * blocks(height, 64) * 4096;
+    break;
+  default:
+    rowStride = storage == GridStorage::PACKED ? (width + 1) & ~1u : width;
+    cellCount = rowStride * height;
+  }
+
+  cells.resize(storage == GridStorage::PACKED ? (cellCount + 1) / 2
+                                               : cellCount);
+  fill(value);
+}
+
+void Grid::fill(CellType value) {
+  auto byte = static_cast<uint8_t>(value);
+  if (storage == GridStorage::PACKED) {
+    byte |= byte << 4;
+  }
+  std::fill(cells.begin(), cells.end(), byte);
+}
@@ -0,0 +1,134 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "game_settings.h"
+#include "memory_tracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef DEFAULT_GRID_LAYOUT
+#define DEFAULT_GRID_LAYOUT "row"
+#endif
+
+#ifndef DEFAULT_GRID_STORAGE
+#define DEFAULT_GRID_STORAGE "byte"
+#endif
+
+enum class GridLayout {
+  ROW_MAJOR, // rows stored one after another
+  TILED,     // 8x8 tiles, rows inside a tile
+  MORTON     // 64x64 blocks, Z-order inside a block
+};
+
+enum class GridStorage {
+  BYTE,  // one byte per cell
+  PACKED // two cells per byte
+};
+
+GridLayout parseGridLayout(const std::string &name);
+std::string gridLayoutName(GridLayout layout);
+GridStorage parseGridStorage(const std::string &name);
+std::string gridStorageName(GridStorage storage);
+
+class Grid {
+  /**
+   * @brief 2D grid of cells stored in a single buffer.
+   * Vertical neighbours are a full row apart in row-major order, the tiled
+   * and Morton layouts keep 2D neighbourhoods in the same cache lines. The
+   * layout is hidden behind get/set and the grid[y][x] row views, so code
+   * written against std::vector<std::vector<CellType>> keeps working.
+   * Packed storage keeps every cell in 4 bits, halving the footprint of
+   * huge maps at the cost of a shift and mask on every access.
+   */
+public:
+  class RowView {
+  public:
+    RowView(const Grid &grid, int y) : grid(grid), y(y) {}
+    CellType operator[](int x) const { return grid.get(x, y); }
+    size_t size() const { return grid.width; }
+
+  private:
+    const Grid &grid;
+    int y;
+  };
+
+  Grid() = default;
+  Grid(unsigned int width, unsigned int height,
+       GridLayout layout = parseGridLayout(DEFAULT_GRID_LAYOUT),
+       GridStorage storage = parseGridStorage(DEFAULT_GRID_STORAGE),
+       CellType value = CellType::EMPTY);
+
+  CellType get(int x, int y) const {
+    auto position = index(x, y);
+    if (storage == GridStorage::BYTE) {
+      return static_cast<CellType>(cells[position]);
+    }
+    return static_cast<CellType>(
+        (cells[position >> 1] >> ((position & 1) << 2)) & 0x0F);
+  }
+
+  void set(int x, int y, CellType value) {
+    auto position = index(x, y);
+    if (storage == GridStorage::BYTE) {
+      cells[position] = static_cast<uint8_t>(value);
+      return;
+    }
+    auto shift = (position & 1) << 2;
+    auto &byte = cells[position >> 1];
+    byte = (byte & ~(0x0F << shift)) | (static_cast<uint8_t>(value) << shift);
+  }
+
+  void fill(CellType value);
+
+  // Row access mirroring a vector of rows: grid[y][x], grid.size() rows
+  RowView operator[](int y) const { return RowView(*this, y); }
+  size_t size() const { return height; }
+  bool empty() const { return height == 0; }
+
+  unsigned int getWidth() const { return width; }
+  unsigned int getHeight() const { return height; }
+  GridLayout getLayout() const { return layout; }
+  GridStorage getStorage() const { return storage; }
+
+  // Position of the cell in the underlying buffer
+  size_t index(int x, int y) const {
+    switch (layout) {
+    case GridLayout::TILED:
+      return ((static_cast<size_t>(y >> 3) * blocksPerRow + (x >> 3)) << 6) |
+             ((y & 7) << 3) | (x & 7);
+    case GridLayout::MORTON:
+      return ((static_cast<size_t>(y >> 6) * blocksPerRow + (x >> 6)) << 12) |
+             spreadBits(x & 63) | (spreadBits(y & 63) << 1);
+    default:
+      return static_cast<size_t>(y) * rowStride + x;
+    }
+  }
+
+  // Number of cells in the buffer, including padding of partial blocks
+  size_t capacity() const { return cellCount; }
+
+  // Size of the cell buffer, half of capacity() for packed storage
+  size_t getBytes() const { return cells.size(); }
+
+private:
+  unsigned int width = 0;
+  unsigned int height = 0;
+  GridLayout layout = GridLayout::ROW_MAJOR;
+  GridStorage storage = GridStorage::BYTE;
+  size_t blocksPerRow = 0;
+  size_t rowStride = 0; // even for packed storage, so no byte spans two rows
+  size_t cellCount = 0;
+  std::vector<uint8_t, TrackingAllocator<uint8_t, MemoryTag::MAP_GRID>> cells;
+
+  // Inserts a zero bit above each bit of a value below 256
+  static size_t spreadBits(size_t value) {
+    value = (value | (value << 4)) & 0x0F0F;
+    value = (value | (value << 2)) & 0x3333;
+    value = (value | (value << 1)) & 0x5555;
+    return value;
+  }
+};
+
+#endif // GRID_H
@@ -1,50 +1,93 @@
 #ifndef _INFO_DEQUE_H
 #define _INFO_DEQUE_H
 
+#include "memory_tracker.h"
 #include <algorithm>
 #include <deque>
 #include <string>
 #include <vector>
 
+using MessageStorage =
+    std::deque<std::vector<std::string>,
+               TrackingAllocator<std::vector<std::string>,
+                                 MemoryTag::MESSAGE_LOG>>;
+
 class ReverseWrapper {
-  std::deque<std::vector<std::string>> &info;
+  MessageStorage &info;
   int startIndex;
 
 public:
-  ReverseWrapper(std::deque<std::vector<std::string>> &info, int startIndex)
+  ReverseWrapper(MessageStorage &info, int startIndex)
       : info(info), startIndex(startIndex) {}
 
-  std::deque<std::vector<std::string>>::reverse_iterator begin() {
+  MessageStorage::reverse_iterator begin() {
     auto it = info.rbegin();
     std::advance(it, startIndex);
     return it;
   }
 
-  std::deque<std::vector<std::string>>::reverse_iterator end() {
-    return info.rend();
-  }
+  MessageStorage::reverse_iterator end() { return info.rend(); }
 };
 
 class InfoDeque {
 private:
-  std::deque<std::vector<std::string>> info;
+  MessageStorage info;
   size_t maxSize;
   int startIndex = 0;
+  size_t payloadBytes = 0;
+
+  // The deque nodes are counted by the allocator, the strings they hold are
+  // accounted here so the message log total includes the text itself.
+  static size_t messageBytes(const std::vector<std::string> &message) {
+    size_t bytes = message.capacity() * sizeof(std::string);
+    for (const auto &line : message) {
+      auto *object = reinterpret_cast<const char *>(&line);
+      bool isInline =
+          line.data() >= object && line.data() < object + sizeof(line);
+      if (!isInline) {
+        bytes += line.capacity() + 1;
+      }
+    }
+    return bytes;
+  }
+
+  void push(std::vector<std::string> &&message) {
+    if (info.size() >= maxSize) {
+      auto bytes = messageBytes(info.front());
+      payloadBytes -= bytes;
+      MemoryTracker::getInstance().recordDeallocation(MemoryTag::MESSAGE_LOG,
+                                                      bytes);
+      info.pop_front();
+    }
+    auto bytes = messageBytes(message);
+    payloadBytes += bytes;
+    MemoryTracker::getInstance().recordAllocation(MemoryTag::MESSAGE_LOG,
+                                                  bytes);
+    info.push_back(std::move(message));
+  }
 
 public:
   InfoDeque(size_t maxSize) : maxSize(maxSize) {}
 
+  InfoDeque(const InfoDeque &other)
+      : info(other.info), maxSize(other.maxSize), startIndex(other.startIndex),
+        payloadBytes(other.payloadBytes) {
+    MemoryTracker::getInstance().recordAllocation(MemoryTag::MESSAGE_LOG,
+                                                  payloadBytes);
+  }
+
+  InfoDeque &operator=(const InfoDeque &) = delete;
+
+  ~InfoDeque() {
+    MemoryTracker::getInstance().recordDeallocation(MemoryTag::MESSAGE_LOG,
+                                                    payloadBytes);
+  }
+
   void addMessage(const std::vector<std::string> &message) {
-    if (info.size() >= maxSize) {
-      info.pop_front();
-    }
-    info.push_back(message);
+    push(std::vector<std::string>(message));
   }
   void addMessage(std::string &&message) {
-    if (info.size() >= maxSize) {
-      info.pop_front();
-    }
-    info.push_back(std::vector<std::string>{std::move(message)});
+    push(std::vector<std::string>{std::move(message)});
   }
 
   std::vector<std::string> front() { return info.front(); }
@@ -55,19 +98,13 @@ public:
 
   bool empty() const { return info.empty(); }
 
-  std::deque<std::vector<std::string>>::iterator begin() {
-    return info.begin();
-  }
+  MessageStorage::iterator begin() { return info.begin(); }
 
-  std::deque<std::vector<std::string>>::iterator end() { return info.end(); }
+  MessageStorage::iterator end() { return info.end(); }
 
-  std::deque<std::vector<std::string>>::const_iterator begin() const {
-    return info.begin();
-  }
+  MessageStorage::const_iterator begin() const { return info.begin(); }
 
-  std::deque<std::vector<std::string>>::const_iterator end() const {
-    return info.end();
-  }
+  MessageStorage::const_iterator end() const { return info.end(); }
 
   void increaseStartIndex() {
     if (startIndex < info.size() - 1) {
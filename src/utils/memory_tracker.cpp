@@ -0,0 +1,87 @@
+#include "memory_tracker.h"
+#include <cstdio>
+
+void MemoryTracker::recordAllocation(MemoryTag tag, size_t bytes) {
+  auto &counter = counters[static_cast<size_t>(tag)];
+  auto live = counter.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+  auto peak = counter.peak.load(std::memory_order_relaxed);
+  while (live > peak && !counter.peak.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryTracker::recordDeallocation(MemoryTag tag, size_t bytes) {
+  counters[static_cast<size_t>(tag)].live.fetch_sub(bytes,
+                                                    std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getLiveBytes(MemoryTag tag) const {
+  return counters[static_cast<size_t>(tag)].live.load(
+      std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getPeakBytes(MemoryTag tag) const {
+  return counters[static_cast<size_t>(tag)].peak.load(
+      std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getTotalLiveBytes() const {
+  size_t total = 0;
+  for (const auto &counter : counters) {
+    total += counter.live.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void MemoryTracker::resetPeaks() {
+  for (auto &counter : counters) {
+    counter.peak.store(counter.live.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+  }
+}
+
+std::vector<MemoryUsage> MemoryTracker::getUsage() const {
+  std::vector<MemoryUsage> usage;
+  usage.reserve(counters.size());
+
+  for (size_t i = 0; i < counters.size(); ++i) {
+    auto tag = static_cast<MemoryTag>(i);
+    usage.push_back({tag, getLiveBytes(tag), getPeakBytes(tag)});
+  }
+
+  return usage;
+}
+
+std::string MemoryTracker::tagName(MemoryTag tag) {
+  switch (tag) {
+  case MemoryTag::MAP_GRID:
+    return "Map grid";
+  case MemoryTag::ENTITIES:
+    return "Entities";
+  case MemoryTag::PATHFINDING:
+    return "Pathfinding";
+  case MemoryTag::MESSAGE_LOG:
+    return "Message log";
+  case MemoryTag::RENDERER:
+    return "Renderer";
+  default:
+    return "Unknown";
+  }
+}
+
+std::string MemoryTracker::formatBytes(size_t bytes) {
+  const char *units[] = {"B", "KiB", "MiB", "GiB"};
+  double value = static_cast<double>(bytes);
+  size_t unit = 0;
+
+  while (value >= 1024.0 && unit < 3) {
+    value /= 1024.0;
+    ++unit;
+  }
+
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.1f %s",
+                value, units[unit]);
+  return buffer;
+}
@@ -0,0 +1,109 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+enum class MemoryTag {
+  MAP_GRID,
+  ENTITIES,
+  PATHFINDING,
+  MESSAGE_LOG,
+  RENDERER,
+  COUNT
+};
+
+struct MemoryUsage {
+  MemoryTag tag;
+  size_t liveBytes;
+  size_t peakBytes;
+};
+
+class MemoryTracker {
+  /**
+   * @brief Keeps live byte counts and high-water marks per subsystem.
+   * Counters are lock-free so allocations may be recorded from any thread.
+   */
+public:
+  static MemoryTracker &getInstance() {
+    static MemoryTracker instance;
+    return instance;
+  }
+
+  void recordAllocation(MemoryTag tag, size_t bytes);
+  void recordDeallocation(MemoryTag tag, size_t bytes);
+
+  size_t getLiveBytes(MemoryTag tag) const;
+  size_t getPeakBytes(MemoryTag tag) const;
+  size_t getTotalLiveBytes() const;
+  void resetPeaks();
+
+  std::vector<MemoryUsage> getUsage() const;
+
+  static std::string tagName(MemoryTag tag);
+  static std::string formatBytes(size_t bytes);
+
+private:
+  struct Counter {
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> peak{0};
+  };
+
+  std::array<Counter, static_cast<size_t>(MemoryTag::COUNT)> counters;
+
+  MemoryTracker() = default;
+  MemoryTracker(MemoryTracker const &) = delete;
+  void operator=(MemoryTracker const &) = delete;
+};
+
+template <typename T, MemoryTag Tag> class TrackingAllocator {
+  /**
+   * @brief std::allocator replacement that reports every allocation to the
+   * MemoryTracker under the given tag.
+   */
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = TrackingAllocator<U, Tag>;
+  };
+
+  TrackingAllocator() noexcept = default;
+  template <typename U>
+  TrackingAllocator(const TrackingAllocator<U, Tag> &) noexcept {}
+
+  T *allocate(size_t n) {
+    auto bytes = n * sizeof(T);
+    auto *ptr = static_cast<T *>(::operator new(bytes));
+    MemoryTracker::getInstance().recordAllocation(Tag, bytes);
+    return ptr;
+  }
+
+  void deallocate(T *ptr, size_t n) noexcept {
+    MemoryTracker::getInstance().recordDeallocation(Tag, n * sizeof(T));
+    ::operator delete(ptr);
+  }
+
+  template <typename U> bool operator==(const TrackingAllocator<U, Tag> &) const {
+    return true;
+  }
+
+  template <typename U> bool operator!=(const TrackingAllocator<U, Tag> &) const {
+    return false;
+  }
+};
+
+// Same as std::make_shared, but the object and its control block are
+// accounted under the given tag.
+template <MemoryTag Tag, typename T, typename... Args>
+std::shared_ptr<T> makeTracked(Args &&...args) {
+  return std::allocate_shared<T>(TrackingAllocator<T, Tag>(),
+                                 std::forward<Args>(args)...);
+}
+
+#endif // MEMORY_TRACKER_H
@@ -0,0 +1,273 @@
+#include "metrics.h"
+#include "memory_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int Histogram::bucketIndex(uint64_t value) {
+  if (value < subBuckets) {
+    return static_cast<int>(value);
+  }
+  int magnitude = 63 - __builtin_clzll(value);
+  int subBucket = static_cast<int>(value >> (magnitude - 3)) - subBuckets;
+  return (magnitude - 2) * subBuckets + subBucket;
+}
+
+uint64_t Histogram::bucketLowerBound(int index) {
+  if (index < subBuckets) {
+    return static_cast<uint64_t>(index);
+  }
+  int magnitude = index / subBuckets + 2;
+  uint64_t subBucket = index % subBuckets;
+  return (subBuckets + subBucket) << (magnitude - 3);
+}
+
+uint64_t Histogram::percentile(double percent) const {
+  auto total = getCount();
+  if (total == 0) {
+    return 0;
+  }
+
+  auto rank = static_cast<uint64_t>(std::ceil(total * percent / 100.0));
+  uint64_t seen = 0;
+  for (int i = 0; i < bucketCount; ++i) {
+    seen += buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank && seen > 0) {
+      return i + 1 < bucketCount ? bucketLowerBound(i + 1) - 1 : UINT64_MAX;
+    }
+  }
+  return UINT64_MAX;
+}
+
+uint64_t Histogram::countBelowPowerOfTwo(int exponent) const {
+  int end = exponent < 3 ? (1 << exponent) : (exponent - 2) * subBuckets;
+  end = std::min(end, bucketCount);
+
+  uint64_t total = 0;
+  for (int i = 0; i < end; ++i) {
+    total += buckets[i].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+MetricsRegistry::~MetricsRegistry() { stopExporter(); }
+
+Counter &MetricsRegistry::counter(const std::string &name,
+                                  const std::string &help) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &entry = counters[name];
+  if (!entry.metric) {
+    entry = {help, std::make_unique<Counter>()};
+  }
+  if (entry.help.empty()) {
+    entry.help = help;
+  }
+  return *entry.metric;
+}
+
+Gauge &MetricsRegistry::gauge(const std::string &name,
+                              const std::string &help) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &entry = gauges[name];
+  if (!entry.metric) {
+    entry = {help, std::make_unique<Gauge>()};
+  }
+  if (entry.help.empty()) {
+    entry.help = help;
+  }
+  return *entry.metric;
+}
+
+Histogram &MetricsRegistry::histogram(const std::string &name,
+                                      const std::string &help, double scale) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &entry = histograms[name];
+  if (!entry.metric) {
+    entry = {help, std::make_unique<Histogram>(scale)};
+  }
+  if (entry.help.empty()) {
+    entry.help = help;
+  }
+  return *entry.metric;
+}
+
+std::string MetricsRegistry::exportPrometheus() const {
+  std::ostringstream out;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (const auto &[name, entry] : counters) {
+    out << "# HELP " << name << " " << entry.help << "\n";
+    out << "# TYPE " << name << " counter\n";
+    out << name << " " << entry.metric->get() << "\n";
+  }
+
+  for (const auto &[name, entry] : gauges) {
+    out << "# HELP " << name << " " << entry.help << "\n";
+    out << "# TYPE " << name << " gauge\n";
+    out << name << " " << entry.metric->get() << "\n";
+  }
+
+  for (const auto &[name, entry] : histograms) {
+    const auto &histogram = *entry.metric;
+    auto count = histogram.getCount();
+    out << "# HELP " << name << " " << entry.help << "\n";
+    out << "# TYPE " << name << " histogram\n";
+
+    // Power of two boundaries line up with the HDR buckets, so the
+    // cumulative counts below are exact.
+    for (int exponent = 0; exponent < 64; ++exponent) {
+      auto below = histogram.countBelowPowerOfTwo(exponent);
+      if (below == 0 && exponent < 63) {
+        continue;
+      }
+      out << name << "_bucket{le=\""
+          << std::ldexp(1.0, exponent) * histogram.getScale() << "\"} "
+          << below << "\n";
+      if (below == count) {
+        break;
+      }
+    }
+    out << name << "_bucket{le=\"+Inf\"} " << count << "\n";
+    out << name << "_sum " << histogram.getSum() * histogram.getScale()
+        << "\n";
+    out << name << "_count " << count << "\n";
+  }
+
+  const auto &tracker = MemoryTracker::getInstance();
+  out << "# HELP md_memory_live_bytes Live bytes per subsystem\n";
+  out << "# TYPE md_memory_live_bytes gauge\n";
+  for (const auto &usage : tracker.getUsage()) {
+    out << "md_memory_live_bytes{subsystem=\""
+        << MemoryTracker::tagName(usage.tag) << "\"} " << usage.liveBytes
+        << "\n";
+  }
+  out << "# HELP md_memory_peak_bytes Peak bytes per subsystem\n";
+  out << "# TYPE md_memory_peak_bytes gauge\n";
+  for (const auto &usage : tracker.getUsage()) {
+    out << "md_memory_peak_bytes{subsystem=\""
+        << MemoryTracker::tagName(usage.tag) << "\"} " << usage.peakBytes
+        << "\n";
+  }
+
+  return out.str();
+}
+
+bool MetricsRegistry::startExporter(const std::string &target,
+                                    std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(exporterMutex);
+  if (exporterRunning || target.empty()) {
+    return false;
+  }
+  exporterRunning = true;
+
+  const std::string socketPrefix = "unix:";
+  if (target.compare(0, socketPrefix.size(), socketPrefix) == 0) {
+    exporter = std::thread(&MetricsRegistry::serveOnSocket, this,
+                           target.substr(socketPrefix.size()));
+  } else {
+    exporter =
+        std::thread(&MetricsRegistry::exportToFile, this, target, interval);
+  }
+  return true;
+}
+
+void MetricsRegistry::stopExporter() {
+  {
+    std::lock_guard<std::mutex> lock(exporterMutex);
+    if (!exporterRunning) {
+      return;
+    }
+    exporterRunning = false;
+  }
+  exporterWakeUp.notify_all();
+  if (exporter.joinable()) {
+    exporter.join();
+  }
+}
+
+void MetricsRegistry::exportToFile(const std::string &path,
+                                   std::chrono::milliseconds interval) {
+  auto writeSnapshot = [&]() {
+    // Write next to the target and rename, so scrapers never see a
+    // partially written file
+    auto temporaryPath = path + ".tmp";
+    {
+      std::ofstream file(temporaryPath, std::ios::trunc);
+      file << exportPrometheus();
+    }
+    std::rename(temporaryPath.c_str(), path.c_str());
+  };
+
+  std::unique_lock<std::mutex> lock(exporterMutex);
+  while (exporterRunning) {
+    lock.unlock();
+    writeSnapshot();
+    lock.lock();
+    exporterWakeUp.wait_for(lock, interval);
+  }
+  lock.unlock();
+  writeSnapshot();
+}
+
+void MetricsRegistry::serveOnSocket(const std::string &path) {
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::snprintf(address.sun_path, sizeof(address.sun_path), "%s",
+                path.c_str());
+  unlink(path.c_str());
+
+  if (server < 0 ||
+      bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+          0 ||
+      listen(server, 4) < 0) {
+    if (server >= 0) {
+      close(server);
+    }
+    return;
+  }
+
+  auto isRunning = [this]() {
+    std::lock_guard<std::mutex> lock(exporterMutex);
+    return exporterRunning;
+  };
+
+  // Answer every connection with a minimal HTTP response, so the socket can
+  // be scraped with e.g. curl --unix-socket
+  while (isRunning()) {
+    pollfd descriptor{server, POLLIN, 0};
+    if (poll(&descriptor, 1, 100) <= 0) {
+      continue;
+    }
+
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+
+    auto body = exportPrometheus();
+    auto response = "HTTP/1.0 200 OK\r\n"
+                    "Content-Type: text/plain; version=0.0.4\r\n"
+                    "Content-Length: " +
+                    std::to_string(body.size()) + "\r\n\r\n" + body;
+    size_t written = 0;
+    while (written < response.size()) {
+      auto result = send(client, response.data() + written,
+                         response.size() - written, MSG_NOSIGNAL);
+      if (result <= 0) {
+        break;
+      }
+      written += result;
+    }
+    close(client);
+  }
+
+  close(server);
+  unlink(path.c_str());
+}
@@ -0,0 +1,150 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Counter {
+public:
+  void increment(uint64_t amount = 1) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+  }
+  uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> value{0};
+};
+
+class Gauge {
+public:
+  void set(int64_t newValue) {
+    value.store(newValue, std::memory_order_relaxed);
+  }
+  void add(int64_t amount) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+  }
+  int64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> value{0};
+};
+
+class Histogram {
+  /**
+   * @brief HDR-style histogram with log-linear buckets.
+   * Every power of two range is split into 8 linear sub-buckets, so any
+   * recorded value is reported with at most 12.5% relative error while the
+   * whole uint64 range fits in a fixed array.
+   */
+public:
+  static constexpr int subBuckets = 8;
+  static constexpr int bucketCount = (64 - 2) * subBuckets;
+
+  // scale converts recorded values to the exported unit,
+  // e.g. 1e-9 for durations recorded in nanoseconds and exported in seconds
+  explicit Histogram(double scale = 1.0) : scale(scale) {}
+
+  void record(uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+  uint64_t getSum() const { return sum.load(std::memory_order_relaxed); }
+  double getScale() const { return scale; }
+
+  // Upper bound of the bucket holding the given percentile (0-100)
+  uint64_t percentile(double percent) const;
+
+  // Number of recorded values lower than 2^exponent
+  uint64_t countBelowPowerOfTwo(int exponent) const;
+
+  static int bucketIndex(uint64_t value);
+  static uint64_t bucketLowerBound(int index);
+
+private:
+  std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> sum{0};
+  double scale;
+};
+
+// Measures the lifetime of the object and records it in nanoseconds
+class ScopedTimer {
+public:
+  explicit ScopedTimer(Histogram &histogram)
+      : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    histogram.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count()));
+  }
+
+private:
+  Histogram &histogram;
+  std::chrono::steady_clock::time_point start;
+};
+
+class MetricsRegistry {
+  /**
+   * @brief Process wide registry of counters, gauges and histograms.
+   * Metrics are registered once (usually into a function-local static
+   * reference) and updated lock-free afterwards. The registry can
+   * periodically export all metrics in Prometheus text format to a file,
+   * or serve them on a Unix socket when the target starts with "unix:".
+   */
+public:
+  static MetricsRegistry &getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+  }
+
+  Counter &counter(const std::string &name, const std::string &help);
+  Gauge &gauge(const std::string &name, const std::string &help);
+  Histogram &histogram(const std::string &name, const std::string &help,
+                       double scale = 1.0);
+
+  std::string exportPrometheus() const;
+
+  bool startExporter(const std::string &target,
+                     std::chrono::milliseconds interval);
+  void stopExporter();
+
+  ~MetricsRegistry();
+
+private:
+  template <typename T> struct Entry {
+    std::string help;
+    std::unique_ptr<T> metric;
+  };
+
+  mutable std::mutex mutex;
+  std::map<std::string, Entry<Counter>> counters;
+  std::map<std::string, Entry<Gauge>> gauges;
+  std::map<std::string, Entry<Histogram>> histograms;
+
+  std::thread exporter;
+  std::mutex exporterMutex;
+  std::condition_variable exporterWakeUp;
+  bool exporterRunning = false;
+
+  void exportToFile(const std::string &path,
+                    std::chrono::milliseconds interval);
+  void serveOnSocket(const std::string &path);
+
+  MetricsRegistry() = default;
+  MetricsRegistry(MetricsRegistry const &) = delete;
+  void operator=(MetricsRegistry const &) = delete;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,174 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fstream>
+#include <map>
+#include <sys/time.h>
+#include <unordered_map>
+
+thread_local volatile ProfilePhase Profiler::currentPhase = ProfilePhase::OTHER;
+
+namespace {
+// Frames belonging to the signal handler and the kernel signal trampoline
+const int signalFrames = 2;
+
+std::string symbolize(void *address) {
+  Dl_info info{};
+  if (!dladdr(address, &info)) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%p", address);
+    return buffer;
+  }
+
+  if (info.dli_sname) {
+    int status = 0;
+    char *demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : info.dli_sname;
+    std::free(demangled);
+    return name;
+  }
+
+  // Unexported symbol, keep module and offset so addr2line can resolve it
+  std::string module = info.dli_fname ? info.dli_fname : "??";
+  module = module.substr(module.find_last_of('/') + 1);
+  char offset[32];
+  std::snprintf(offset, sizeof(offset), "+0x%zx",
+                static_cast<size_t>(static_cast<char *>(address) -
+                                    static_cast<char *>(info.dli_fbase)));
+  return module + offset;
+}
+} // namespace
+
+void Profiler::handleSignal(int, siginfo_t *, void *) {
+  auto &profiler = getInstance();
+  int savedErrno = errno;
+
+  auto index = profiler.next.fetch_add(1, std::memory_order_relaxed);
+  if (index >= profiler.capacity) {
+    profiler.dropped.fetch_add(1, std::memory_order_relaxed);
+    errno = savedErrno;
+    return;
+  }
+
+  auto &sample = profiler.samples[index];
+  sample.phase = currentPhase;
+  int depth = backtrace(sample.frames, maxDepth);
+  sample.depth.store(depth, std::memory_order_release);
+
+  errno = savedErrno;
+}
+
+bool Profiler::start(int frequency, size_t maxSamples) {
+  if (running || frequency <= 0) {
+    return false;
+  }
+
+  samples = std::make_unique<Sample[]>(maxSamples);
+  capacity = maxSamples;
+  next = 0;
+  dropped = 0;
+
+  // backtrace() loads the unwinder lazily, which is not async-signal-safe,
+  // so it is called once here before the first signal can arrive.
+  void *warmUp[1];
+  backtrace(warmUp, 1);
+
+  struct sigaction action {};
+  action.sa_sigaction = &Profiler::handleSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+    return false;
+  }
+
+  // Down to a microsecond, as fine as itimerval goes: a zero period would
+  // disarm the timer, and tv_usec must stay below a second
+  auto period = std::max(1000000L / frequency, 1L);
+  itimerval timer{};
+  timer.it_interval.tv_sec = period / 1000000;
+  timer.it_interval.tv_usec = period % 1000000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    sigaction(SIGPROF, &previousAction, nullptr);
+    return false;
+  }
+
+  running = true;
+  return true;
+}
+
+void Profiler::stop() {
+  if (!running) {
+    return;
+  }
+
+  itimerval timer{};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  sigaction(SIGPROF, &previousAction, nullptr);
+  running = false;
+}
+
+size_t Profiler::getSampleCount() const {
+  return std::min(next.load(), capacity);
+}
+
+std::string Profiler::phaseName(ProfilePhase phase) {
+  switch (phase) {
+  case ProfilePhase::INPUT:
+    return "input";
+  case ProfilePhase::UPDATE:
+    return "update";
+  case ProfilePhase::RENDER:
+    return "render";
+  case ProfilePhase::LEVEL_LOAD:
+    return "level_load";
+  default:
+    return "other";
+  }
+}
+
+bool Profiler::writeFoldedStacks(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    return false;
+  }
+
+  std::unordered_map<char *, std::string> symbols;
+  std::map<std::string, size_t> stacks;
+
+  for (size_t i = 0; i < getSampleCount(); ++i) {
+    const auto &sample = samples[i];
+    int depth = sample.depth.load(std::memory_order_acquire);
+    if (depth <= signalFrames) {
+      continue;
+    }
+
+    // backtrace() lists the innermost frame first, folded stacks start at
+    // the root
+    std::string stack = phaseName(sample.phase);
+    for (int frame = depth - 1; frame >= signalFrames; --frame) {
+      auto *address = static_cast<char *>(sample.frames[frame]);
+      // Outer frames hold return addresses, which point after the call
+      if (frame > signalFrames) {
+        --address;
+      }
+      auto symbol = symbols.find(address);
+      if (symbol == symbols.end()) {
+        symbol = symbols.emplace(address, symbolize(address)).first;
+      }
+      stack += ';' + symbol->second;
+    }
+    ++stacks[stack];
+  }
+
+  for (const auto &[stack, count] : stacks) {
+    out << stack << ' ' << count << '\n';
+  }
+  return true;
+}
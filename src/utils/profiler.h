@@ -0,0 +1,79 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+enum class ProfilePhase : int { OTHER, INPUT, UPDATE, RENDER, LEVEL_LOAD };
+
+class Profiler {
+  /**
+   * @brief Sampling profiler driven by SIGPROF.
+   * A CPU time interval timer interrupts the process at a fixed rate and the
+   * signal handler copies the interrupted stack into a preallocated sample
+   * buffer, tagged with the game phase of the interrupted thread. Samples
+   * are symbolized only when the folded stacks are written, so the handler
+   * itself never allocates or locks.
+   */
+public:
+  static constexpr int maxDepth = 64;
+
+  static Profiler &getInstance() {
+    static Profiler instance;
+    return instance;
+  }
+
+  bool start(int frequency = 997, size_t maxSamples = 1 << 16);
+  void stop();
+  bool isRunning() const { return running; }
+
+  // Writes samples in the folded stack format used by flamegraph.pl,
+  // one "phase;outermost;...;innermost count" line per unique stack.
+  bool writeFoldedStacks(const std::string &path) const;
+
+  size_t getSampleCount() const;
+  size_t getDroppedCount() const { return dropped.load(); }
+
+  static void setPhase(ProfilePhase phase) { currentPhase = phase; }
+  static ProfilePhase getPhase() { return currentPhase; }
+  static std::string phaseName(ProfilePhase phase);
+
+  // Tags everything sampled during its lifetime with the given phase
+  class PhaseScope {
+  public:
+    explicit PhaseScope(ProfilePhase phase) : previous(getPhase()) {
+      setPhase(phase);
+    }
+    ~PhaseScope() { setPhase(previous); }
+
+  private:
+    ProfilePhase previous;
+  };
+
+private:
+  struct Sample {
+    std::atomic<int> depth{0}; // 0 until the handler finished writing it
+    ProfilePhase phase;
+    void *frames[maxDepth];
+  };
+
+  static thread_local volatile ProfilePhase currentPhase;
+
+  std::unique_ptr<Sample[]> samples;
+  size_t capacity = 0;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> dropped{0};
+  bool running = false;
+  struct sigaction previousAction {};
+
+  static void handleSignal(int signal, siginfo_t *info, void *context);
+
+  Profiler() = default;
+  Profiler(Profiler const &) = delete;
+  void operator=(Profiler const &) = delete;
+};
+
+#endif // PROFILER_H
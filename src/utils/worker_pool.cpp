@@ -0,0 +1,84 @@
+#include "worker_pool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned int threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned int i = 1; i < threadCount; ++i) {
+    workers.emplace_back(&WorkerPool::workerLoop, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void WorkerPool::parallelFor(size_t count,
+                             const std::function<void(size_t)> &loopTask) {
+  if (count == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &loopTask;
+    taskCount = count;
+    nextTask = 0;
+    busyWorkers = workers.size();
+    error = nullptr;
+    ++generation;
+  }
+  wakeUp.notify_all();
+
+  runTasks();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [this]() { return busyWorkers == 0; });
+  task = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkerPool::workerLoop() {
+  uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeUp.wait(lock, [&]() { return stopping || generation != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = generation;
+    }
+
+    runTasks();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--busyWorkers == 0) {
+      finished.notify_one();
+    }
+  }
+}
+
+void WorkerPool::runTasks() {
+  size_t index;
+  while ((index = nextTask.fetch_add(1)) < taskCount) {
+    try {
+      (*task)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+  /**
+   * @brief Fixed set of threads running parallel loops.
+   * parallelFor hands out task indices from a shared counter, the calling
+   * thread takes part as well, and the call returns once every task has
+   * finished. Threads are started once, so a loop per game tick costs a
+   * wake-up instead of a thread creation.
+   */
+public:
+  // threadCount includes the calling thread, 0 uses every hardware thread
+  explicit WorkerPool(unsigned int threadCount = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Runs task(0) ... task(count - 1), rethrows the first exception thrown
+  void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+  unsigned int size() const { return workers.size() + 1; }
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  std::condition_variable finished;
+
+  // State of the running loop, guarded by mutex except for the counters
+  const std::function<void(size_t)> *task = nullptr;
+  size_t taskCount = 0;
+  std::atomic<size_t> nextTask{0};
+  size_t busyWorkers = 0;
+  uint64_t generation = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+
+  void workerLoop();
+  void runTasks();
+};
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,65 @@
+#ifndef ZOBRIST_HASH_H
+#define ZOBRIST_HASH_H
+
+#include "game_settings.h"
+#include "point.h"
+#include <atomic>
+#include <cstdint>
+
+class ZobristHash {
+  /**
+   * @brief Incremental 64-bit hash of a set of features.
+   * Every feature (a cell holding a wall, a goblin with 30 health at 4,7)
+   * has a pseudo-random key and the hash is the XOR of the keys of the
+   * features present. Adding or removing a feature is a single XOR, and
+   * the result does not depend on the order of the updates, so workers
+   * moving entities in different map strips can share one hash. Keys are
+   * derived from the feature by a 64-bit mixer instead of being looked up
+   * in a random table, which would take gigabytes on huge maps.
+   */
+public:
+  static constexpr uint64_t cellSeed = 0x6D2E6F7C9A3B1E45ull;
+  static constexpr uint64_t entitySeed = 0xC1F4A2B38E7D9065ull;
+
+  ZobristHash() = default;
+  ZobristHash(const ZobristHash &other) : value(other.get()) {}
+  ZobristHash &operator=(const ZobristHash &other) {
+    reset(other.get());
+    return *this;
+  }
+
+  // Key of a feature, extended one field at a time
+  static uint64_t combine(uint64_t key, uint64_t field) {
+    return mix(key ^ mix(field + 0x9E3779B97F4A7C15ull));
+  }
+
+  // Key of a cell holding cellType, empty cells add nothing
+  static uint64_t cellKey(const Point &point, CellType cellType) {
+    if (cellType == CellType::EMPTY) {
+      return 0;
+    }
+    return combine(combine(combine(cellSeed, static_cast<uint32_t>(point.x)),
+                           static_cast<uint32_t>(point.y)),
+                   static_cast<uint64_t>(cellType));
+  }
+
+  // Adds a feature that is absent, removes one that is present
+  void toggle(uint64_t key) { value.fetch_xor(key, std::memory_order_relaxed); }
+
+  uint64_t get() const { return value.load(std::memory_order_relaxed); }
+  void reset(uint64_t hash = 0) {
+    value.store(hash, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> value{0};
+
+  // splitmix64 finalizer
+  static uint64_t mix(uint64_t key) {
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+  }
+};
+
+#endif // ZOBRIST_HASH_H
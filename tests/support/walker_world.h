@@ -0,0 +1,75 @@
+#ifndef WALKER_WORLD_H
+#define WALKER_WORLD_H
+
+// Fixtures shared by the unit tests and the benchmarks: open maps, and
+// monsters wandering them under the rules of Model::attemptMonsterMove
+// without a whole Model around them.
+
+#include "model/entities/monster.h"
+#include "model/map.h"
+#include "model/spatial_index.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Map of width x height with no walls
+inline std::shared_ptr<Map> openMap(unsigned int width, unsigned int height) {
+  auto map = std::make_shared<Map>(width, height);
+  map->grid = Grid(width, height);
+  return map;
+}
+
+// Goblin-like monster that picks a new direction after every step
+class Walker : public Monster {
+public:
+  explicit Walker(uint32_t id) : Monster(CellType::GOBLIN, 100, 10) {
+    seed(id + 1);
+    randomizeVelocity();
+  }
+  void move(const Point &destination) override {
+    MovableEntity::move(destination);
+    randomizeVelocity();
+  }
+  std::string toString() const override { return "Walker"; }
+  std::shared_ptr<Monster> clone(const MonsterWorld &) const override {
+    return std::make_shared<Walker>(*this);
+  }
+};
+
+struct WalkerWorld {
+  std::shared_ptr<Map> map;
+  SpatialIndex index;
+  MonsterList monsters;
+
+  WalkerWorld(unsigned int width, unsigned int height)
+      : map(openMap(width, height)), index(width, height) {}
+
+  // Puts walker number id on position, unless the cell is taken
+  bool addWalker(const Point &position, uint32_t id) {
+    if (!map->isPositionFree(position)) {
+      return false;
+    }
+    auto walker = std::make_shared<Walker>(id);
+    walker->position = position;
+    map->setCellType(position, walker->cellType);
+    index.insert(walker.get());
+    monsters.push_back(walker);
+    return true;
+  }
+
+  // Same rules as Model::attemptMonsterMove for a monster that does not
+  // meet the player: step into free cells, turn around at obstacles
+  bool tryMove(const std::shared_ptr<Monster> &monster, const Point &target) {
+    if (!map->isPositionFree(target)) {
+      monster->randomizeVelocity();
+      return false;
+    }
+    map->setCellType(monster->position, CellType::EMPTY);
+    map->setCellType(target, monster->cellType);
+    index.move(monster.get(), monster->position, target);
+    monster->move(target);
+    return true;
+  }
+};
+
+#endif // WALKER_WORLD_H
@@ -0,0 +1,90 @@
+#include "model/command_buffer.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(CommandBufferTest, InterleavesPlayersRoundByRound) {
+  // Arrange
+  CommandBuffer commands;
+  commands.submit(CommandType::MOVE, 2, Point(1, 0));
+  commands.submit(CommandType::MOVE, 2, Point(0, 1));
+  commands.submit(CommandType::MOVE, 2, Point(-1, 0));
+  commands.submit(CommandType::MOVE, 1, Point(0, -1));
+  commands.submit(CommandType::LEAVE, 1);
+
+  // Act
+  auto batch = commands.take();
+
+  // Assert
+  ASSERT_EQ(batch.size(), 5u);
+  EXPECT_EQ(batch[0].playerId, 1);
+  EXPECT_EQ(batch[0].direction, Point(0, -1));
+  EXPECT_EQ(batch[1].playerId, 2);
+  EXPECT_EQ(batch[1].direction, Point(1, 0));
+  EXPECT_EQ(batch[2].type, CommandType::LEAVE);
+  EXPECT_EQ(batch[3].direction, Point(0, 1));
+  EXPECT_EQ(batch[4].direction, Point(-1, 0));
+  EXPECT_EQ(commands.pending(), 0u);
+}
+
+TEST(CommandBufferTest, ConcurrentProducersLoseNothing) {
+  // Arrange
+  CommandBuffer commands;
+  const int producers = 4;
+  const int movesEach = 1000;
+  std::vector<int> ids(producers);
+  std::vector<std::thread> threads;
+
+  // Act
+  for (int i = 0; i < producers; ++i) {
+    threads.emplace_back([&, i]() {
+      ids[i] = commands.reservePlayerId();
+      for (int move = 0; move < movesEach; ++move) {
+        commands.submit(CommandType::MOVE, ids[i], Point(move, 0));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto batch = commands.take();
+
+  // Assert
+  std::set<int> uniqueIds(ids.begin(), ids.end());
+  EXPECT_EQ(uniqueIds.size(), static_cast<size_t>(producers));
+  EXPECT_EQ(uniqueIds.count(CommandBuffer::localPlayerId), 0u);
+  ASSERT_EQ(batch.size(), static_cast<size_t>(producers * movesEach));
+  // Every player's own commands keep the order they were submitted in
+  std::vector<int> next(producers + 1, 0);
+  for (const auto &command : batch) {
+    EXPECT_EQ(command.direction.x, next[command.playerId]++);
+  }
+}
+
+TEST(CommandBufferTest, DropsMovesBeyondTheLimitUntilTaken) {
+  // Arrange
+  CommandBuffer commands(2);
+  commands.submit(CommandType::JOIN, 1);
+  for (int move = 0; move < 5; ++move) {
+    commands.submit(CommandType::MOVE, 1, Point(move, 0));
+    commands.submit(CommandType::MOVE, 2, Point(move, 0));
+  }
+  commands.submit(CommandType::LEAVE, 1);
+
+  // Act
+  auto batch = commands.take();
+  commands.submit(CommandType::MOVE, 1, Point(5, 0));
+  auto next = commands.take();
+
+  // Assert
+  ASSERT_EQ(batch.size(), 6u);
+  EXPECT_EQ(batch[0].type, CommandType::JOIN);
+  EXPECT_EQ(batch[1].direction, Point(0, 0));
+  EXPECT_EQ(batch[2].direction, Point(0, 0));
+  EXPECT_EQ(batch[3].direction, Point(1, 0));
+  EXPECT_EQ(batch[4].direction, Point(1, 0));
+  EXPECT_EQ(batch[5].type, CommandType::LEAVE);
+  ASSERT_EQ(next.size(), 1u);
+  EXPECT_EQ(next[0].direction, Point(5, 0));
+}
@@ -0,0 +1,98 @@
+#include "algorithms/connected_components.h"
+#include "gtest/gtest.h"
+#include <set>
+
+namespace {
+// Noise walls over a grid tall enough for several strips, so areas have
+// to be joined across the strip borders
+Grid noiseGrid(unsigned int width, unsigned int height, unsigned int seed) {
+  Grid grid(width, height);
+  for (unsigned int y = 0; y < height; ++y) {
+    for (unsigned int x = 0; x < width; ++x) {
+      seed = seed * 1103515245u + 12345u;
+      grid.set(x, y, (seed >> 16) % 100 < 45 ? CellType::WALL
+                                             : CellType::EMPTY);
+    }
+  }
+  return grid;
+}
+} // namespace
+
+TEST(ConnectedComponentsTest, SeparatesAreasSplitByWalls) {
+  // Arrange
+  Grid grid(10, 200);
+  for (unsigned int y = 0; y < 200; ++y) {
+    grid.set(4, y, CellType::WALL);
+  }
+  for (unsigned int x = 5; x < 10; ++x) {
+    grid.set(x, 100, CellType::WALL);
+  }
+
+  // Act
+  ConnectedComponents components(grid);
+
+  // Assert
+  EXPECT_EQ(components.count(), 3u);
+  EXPECT_TRUE(components.connected(Point(0, 0), Point(3, 199)));
+  EXPECT_FALSE(components.connected(Point(0, 0), Point(5, 0)));
+  EXPECT_TRUE(components.connected(Point(5, 0), Point(9, 99)));
+  EXPECT_FALSE(components.connected(Point(5, 0), Point(9, 101)));
+  EXPECT_EQ(components.labelAt(Point(4, 10)), ConnectedComponents::none);
+  EXPECT_EQ(components.labelAt(Point(-1, 0)), ConnectedComponents::none);
+  EXPECT_FALSE(components.connected(Point(4, 10), Point(4, 10)));
+  EXPECT_EQ(components.labelAt(Point(7, 150)), 5u + 101u * 10u);
+}
+
+TEST(ConnectedComponentsTest, LabelsDoNotDependOnThePool) {
+  // Arrange
+  auto grid = noiseGrid(97, 331, 5);
+  WorkerPool pool(4);
+
+  // Act
+  ConnectedComponents sequential(grid);
+  ConnectedComponents parallel(grid, &pool);
+
+  // Assert
+  EXPECT_EQ(parallel.count(), sequential.count());
+  std::set<uint32_t> labels;
+  for (int y = 0; y < 331; ++y) {
+    for (int x = 0; x < 97; ++x) {
+      Point point(x, y);
+      ASSERT_EQ(parallel.labelAt(point), sequential.labelAt(point));
+      if (sequential.labelAt(point) != ConnectedComponents::none) {
+        labels.insert(sequential.labelAt(point));
+      }
+    }
+  }
+  EXPECT_EQ(labels.size(), sequential.count());
+}
+
+TEST(ConnectedComponentsTest, MatchesAFloodFill) {
+  // Arrange
+  auto grid = noiseGrid(60, 150, 11);
+  ConnectedComponents components(grid);
+  const Point steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+  // Act & Assert
+  // Neighbouring open cells share labels, and so, transitively, does
+  // every area
+  for (int y = 0; y < 150; ++y) {
+    for (int x = 0; x < 60; ++x) {
+      Point point(x, y);
+      if (grid.get(x, y) == CellType::WALL) {
+        continue;
+      }
+      for (const auto &step : steps) {
+        auto next = point + step;
+        if (next.x >= 0 && next.y >= 0 && next.x < 60 && next.y < 150 &&
+            grid.get(next.x, next.y) != CellType::WALL) {
+          ASSERT_TRUE(components.connected(point, next));
+        }
+      }
+      // Labels name the first cell of the area
+      auto label = components.labelAt(point);
+      ASSERT_LE(label, static_cast<uint32_t>(y * 60 + x));
+      ASSERT_EQ(components.labelAt(Point(label % 60, label / 60)), label);
+    }
+  }
+}
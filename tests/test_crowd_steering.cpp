@@ -0,0 +1,136 @@
+#include "model/crowd_steering.h"
+#include "support/walker_world.h"
+#include "gtest/gtest.h"
+
+namespace {
+// Walks a fixed step, along a path when onPath is set
+class Heading : public Monster {
+public:
+  bool onPath = false;
+
+  Heading(const Point &position, const Point &step)
+      : Monster(CellType::GOBLIN, 100, 10) {
+    this->position = position;
+    velocity = step;
+  }
+  void randomizeVelocity() override {}
+  bool followsPath() override { return onPath; }
+  std::string toString() const override { return "Heading"; }
+  std::shared_ptr<Monster> clone(const MonsterWorld &) const override {
+    return std::make_shared<Heading>(*this);
+  }
+};
+
+std::shared_ptr<Heading> place(Map &map, MonsterList &monsters,
+                               const Point &position, const Point &step) {
+  auto monster = std::make_shared<Heading>(position, step);
+  map.setCellType(position, monster->cellType);
+  monsters.push_back(monster);
+  return monster;
+}
+} // namespace
+
+TEST(CrowdSteeringTest, LoneMonstersKeepTheirSteps) {
+  // Arrange
+  auto map = openMap(20, 20);
+  MonsterList monsters;
+  place(*map, monsters, Point(2, 2), Point(1, 0));
+  place(*map, monsters, Point(15, 15), Point(0, -1));
+  CrowdSteering steering;
+
+  // Act
+  steering.plan(*map, monsters);
+
+  // Assert
+  EXPECT_EQ(steering.stepOf(0), Point(1, 0));
+  EXPECT_EQ(steering.stepOf(1), Point(0, -1));
+  EXPECT_FALSE(steering.waits(0));
+  EXPECT_FALSE(steering.waits(1));
+}
+
+TEST(CrowdSteeringTest, QueuesBehindMonstersGoingTheSameWay) {
+  // Arrange
+  auto map = openMap(20, 20);
+  MonsterList monsters;
+  place(*map, monsters, Point(5, 5), Point(1, 0));
+  place(*map, monsters, Point(6, 5), Point(1, 0));
+  place(*map, monsters, Point(7, 5), Point(1, 0));
+  CrowdSteering steering;
+
+  // Act
+  steering.plan(*map, monsters);
+
+  // Assert
+  EXPECT_TRUE(steering.waits(0));
+  EXPECT_TRUE(steering.waits(1));
+  EXPECT_FALSE(steering.waits(2));
+  EXPECT_EQ(steering.stepOf(2), Point(1, 0));
+}
+
+TEST(CrowdSteeringTest, SteersAwayFromCloseNeighbours) {
+  // Arrange
+  auto map = openMap(20, 20);
+  MonsterList monsters;
+  // Walking towards each other along a row
+  place(*map, monsters, Point(5, 5), Point(1, 0));
+  place(*map, monsters, Point(7, 5), Point(-1, 0));
+  // Crowded on one side, the free side is the way out
+  place(*map, monsters, Point(10, 10), Point(0, 1));
+  place(*map, monsters, Point(11, 10), Point(0, 0));
+  place(*map, monsters, Point(11, 11), Point(0, 0));
+  CrowdSteering steering(1.0, 0.0);
+
+  // Act
+  steering.plan(*map, monsters);
+
+  // Assert
+  // Head on, separation is weaker than the steps and both keep going
+  EXPECT_EQ(steering.stepOf(0), Point(1, 0));
+  EXPECT_EQ(steering.stepOf(1), Point(-1, 0));
+  EXPECT_EQ(steering.stepOf(2), Point(-1, 0));
+  EXPECT_FALSE(steering.waits(2));
+}
+
+TEST(CrowdSteeringTest, LeavesPathFollowersAndStandingMonstersAlone) {
+  // Arrange
+  auto map = openMap(20, 20);
+  MonsterList monsters;
+  auto follower = place(*map, monsters, Point(5, 5), Point(1, 0));
+  follower->onPath = true;
+  place(*map, monsters, Point(6, 5), Point(1, 0));
+  place(*map, monsters, Point(5, 6), Point(0, 0));
+  CrowdSteering steering;
+
+  // Act
+  steering.plan(*map, monsters);
+
+  // Assert
+  EXPECT_FALSE(steering.waits(0));
+  EXPECT_EQ(steering.stepOf(0), Point(1, 0));
+  EXPECT_EQ(steering.stepOf(2), Point(0, 0));
+  EXPECT_FALSE(steering.waits(2));
+}
+
+TEST(CrowdSteeringTest, StepsAreTheSameInAnyOrder) {
+  // Arrange
+  auto map = openMap(20, 20);
+  MonsterList monsters;
+  for (int i = 0; i < 40; ++i) {
+    place(*map, monsters, Point((i * 7) % 20, (i * 3 + i / 20) % 20),
+          Point(i % 3 - 1, (i / 3) % 3 - 1));
+  }
+  MonsterList reversed(monsters.rbegin(), monsters.rend());
+  CrowdSteering steering;
+  CrowdSteering reversedSteering;
+
+  // Act
+  steering.plan(*map, monsters);
+  reversedSteering.plan(*map, reversed);
+
+  // Assert
+  for (size_t i = 0; i < monsters.size(); ++i) {
+    auto j = monsters.size() - 1 - i;
+    EXPECT_EQ(steering.stepOf(i), reversedSteering.stepOf(j));
+    EXPECT_EQ(steering.waits(i), reversedSteering.waits(j));
+  }
+}
@@ -0,0 +1,69 @@
+#include "utils/event_logger.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+TEST(EventLoggerTest, WritesEventsFromAllThreadsAndDecodesThem) {
+  // Arrange
+  const std::string path = "test_events.bin";
+  auto &logger = EventLogger::getInstance();
+  ASSERT_TRUE(logger.start(path));
+
+  // Act
+  logger.log(EventType::LEVEL_LOADED, 100, 50);
+  std::thread worker(
+      [&logger]() { logger.log(EventType::PATH_COMPUTED, 7, 3, 4); });
+  worker.join();
+  logger.stop();
+
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream out;
+  bool decoded = EventLogger::decode(in, out);
+  std::remove(path.c_str());
+
+  // Assert
+  ASSERT_TRUE(decoded);
+  auto text = out.str();
+  ASSERT_NE(text.find("LOGGER_STARTED"), std::string::npos);
+  ASSERT_NE(text.find("LEVEL_LOADED width=100 height=50"), std::string::npos);
+  ASSERT_NE(text.find("PATH_COMPUTED length=7 x=3 y=4"), std::string::npos);
+}
+
+TEST(EventLoggerTest, IgnoresEventsWhenStopped) {
+  // Arrange
+  const std::string path = "test_events_stopped.bin";
+  auto &logger = EventLogger::getInstance();
+  ASSERT_TRUE(logger.start(path));
+  logger.stop();
+
+  // Act
+  // Logged between two runs, nothing should hold it for the next one
+  logger.log(EventType::PLAYER_MOVED, 1, 1);
+  ASSERT_TRUE(logger.start(path));
+  logger.log(EventType::LEVEL_LOADED, 100, 50);
+  logger.stop();
+  logger.log(EventType::PLAYER_MOVED, 2, 2);
+
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream out;
+  bool decoded = EventLogger::decode(in, out);
+  std::remove(path.c_str());
+
+  // Assert
+  ASSERT_FALSE(logger.isRunning());
+  ASSERT_TRUE(decoded);
+  auto text = out.str();
+  ASSERT_NE(text.find("LEVEL_LOADED width=100 height=50"), std::string::npos);
+  ASSERT_EQ(text.find("PLAYER_MOVED"), std::string::npos);
+}
+
+TEST(EventLoggerTest, RejectsInvalidLog) {
+  // Arrange
+  std::istringstream in("not an event log");
+  std::ostringstream out;
+
+  // Act & Assert
+  ASSERT_FALSE(EventLogger::decode(in, out));
+}
@@ -0,0 +1,129 @@
+#include "model/floor_stack.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+namespace {
+class Sleeper : public Monster {
+public:
+  Sleeper() : Monster(CellType::TROLL, 50, 5) {}
+  std::string toString() const override { return "Sleeper"; }
+  std::shared_ptr<Monster> clone(const MonsterWorld &) const override {
+    return std::make_shared<Sleeper>(*this);
+  }
+};
+
+std::shared_ptr<Map> makeMap(GridLayout layout = GridLayout::ROW_MAJOR) {
+  auto map = std::make_shared<Map>(70, 45, layout, GridStorage::BYTE);
+  map->loadLevel();
+  map->setCellType(map->getEnd(), CellType::END);
+  return map;
+}
+
+bool sameCells(const Map &first, const Map &second) {
+  if (first.getWidth() != second.getWidth() ||
+      first.getHeight() != second.getHeight()) {
+    return false;
+  }
+  for (unsigned int y = 0; y < first.getHeight(); ++y) {
+    for (unsigned int x = 0; x < first.getWidth(); ++x) {
+      if (first.grid.get(x, y) != second.grid.get(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+FloorStack::Floor makeFloor() {
+  FloorStack::Floor floor{makeMap()};
+  auto monster = std::make_shared<Sleeper>();
+  monster->position = floor.map->randomFreePosition();
+  floor.map->setCellType(monster->position, monster->cellType);
+  floor.monsters.push_back(monster);
+  return floor;
+}
+} // namespace
+
+TEST(FloorStackTest, PackedMapUnpacksToTheSameMap) {
+  // Arrange
+  auto map = makeMap(GridLayout::MORTON);
+
+  // Act
+  auto packed = map->pack();
+  Map unpacked(packed);
+
+  // Assert
+  EXPECT_TRUE(sameCells(*map, unpacked));
+  EXPECT_EQ(unpacked.getStart(), map->getStart());
+  EXPECT_EQ(unpacked.getEnd(), map->getEnd());
+  EXPECT_EQ(unpacked.grid.getLayout(), GridLayout::MORTON);
+  EXPECT_EQ(unpacked.hash.get(), map->computeHash());
+  EXPECT_LT(packed.cells.size(), map->grid.getBytes());
+}
+
+TEST(FloorStackTest, DroppedDerivedDataIsRebuiltWhenUnpacked) {
+  // Arrange
+  auto map = makeMap();
+  auto packed = map->pack();
+
+  // Act
+  packed.dropDerived();
+  Map unpacked(packed);
+
+  // Assert
+  EXPECT_EQ(packed.exitDistances, nullptr);
+  EXPECT_EQ(packed.components, nullptr);
+  EXPECT_LE(packed.residentBytes(), packed.cells.capacity());
+  ASSERT_NE(unpacked.getComponents(), nullptr);
+  EXPECT_TRUE(unpacked.isReachable(map->getStart(), map->getEnd()));
+  for (unsigned int y = 0; y < map->getHeight(); ++y) {
+    for (unsigned int x = 0; x < map->getWidth(); ++x) {
+      ASSERT_EQ(unpacked.exitDistance(Point(x, y)),
+                map->exitDistance(Point(x, y)));
+    }
+  }
+}
+
+TEST(FloorStackTest, LoadsFloorsAsTheyWereStored) {
+  // Arrange
+  FloorStack floors;
+  auto floor = makeFloor();
+  auto position = floor.monsters.front()->position;
+
+  // Act
+  floors.store(0, floor);
+  floor.monsters.front()->takeDamage(20);
+  auto first = floors.load(0, MonsterWorld{});
+  first.monsters.front()->takeDamage(20);
+  auto second = floors.load(0, MonsterWorld{});
+
+  // Assert
+  EXPECT_EQ(floors.size(), 1u);
+  EXPECT_TRUE(sameCells(*floor.map, *second.map));
+  EXPECT_NE(first.map, second.map);
+  ASSERT_EQ(second.monsters.size(), 1u);
+  EXPECT_NE(second.monsters.front(), first.monsters.front());
+  EXPECT_EQ(second.monsters.front()->position, position);
+  EXPECT_EQ(second.monsters.front()->health, 50);
+  EXPECT_GT(floors.packedBytes(), 0u);
+  EXPECT_LT(floors.packedBytes(), floor.map->grid.getBytes());
+}
+
+TEST(FloorStackTest, PrefetchedFloorsLoadTheSame) {
+  // Arrange
+  FloorStack floors;
+  auto floor = makeFloor();
+  floors.store(0, floor);
+  FloorStack copy(floors);
+
+  // Act
+  floors.prefetch(0);
+  floors.prefetch(1); // not stored, ignored
+  auto prefetched = floors.load(0, MonsterWorld{});
+  auto copied = copy.load(0, MonsterWorld{});
+
+  // Assert
+  EXPECT_TRUE(sameCells(*floor.map, *prefetched.map));
+  EXPECT_TRUE(sameCells(*floor.map, *copied.map));
+  EXPECT_EQ(prefetched.map->hash.get(), floor.map->hash.get());
+}
@@ -0,0 +1,112 @@
+#include "algorithms/a_star.h"
+#include "utils/grid.h"
+#include "gtest/gtest.h"
+#include <set>
+
+namespace {
+const GridLayout layouts[] = {GridLayout::ROW_MAJOR, GridLayout::TILED,
+                              GridLayout::MORTON};
+}
+
+TEST(GridTest, EveryLayoutMapsCellsToDistinctIndices) {
+  for (auto layout : layouts) {
+    // Arrange
+    Grid grid(70, 13, layout);
+    std::set<size_t> indices;
+
+    // Act
+    for (int y = 0; y < 13; ++y) {
+      for (int x = 0; x < 70; ++x) {
+        indices.insert(grid.index(x, y));
+      }
+    }
+
+    // Assert
+    EXPECT_EQ(indices.size(), 70u * 13u) << gridLayoutName(layout);
+    EXPECT_LT(*indices.rbegin(), grid.capacity()) << gridLayoutName(layout);
+  }
+}
+
+TEST(GridTest, TiledAndMortonKeepVerticalNeighboursClose) {
+  // Arrange
+  Grid row(4096, 16, GridLayout::ROW_MAJOR);
+  Grid tiled(4096, 16, GridLayout::TILED);
+  Grid morton(4096, 16, GridLayout::MORTON);
+
+  // Act & Assert
+  EXPECT_EQ(row.index(5, 1) - row.index(5, 0), 4096u);
+  EXPECT_EQ(tiled.index(5, 1) - tiled.index(5, 0), 8u);
+  EXPECT_EQ(morton.index(5, 1) - morton.index(5, 0), 2u);
+}
+
+TEST(GridTest, ReadsBackWrittenCellsInEveryLayout) {
+  for (auto layout : layouts) {
+    // Arrange
+    Grid grid(100, 37, layout);
+
+    // Act
+    grid.set(99, 36, CellType::WALL);
+    grid.set(0, 0, CellType::TREASURE);
+    grid.set(64, 8, CellType::ORC);
+
+    // Assert
+    EXPECT_EQ(grid.get(99, 36), CellType::WALL);
+    EXPECT_EQ(grid[0][0], CellType::TREASURE);
+    EXPECT_EQ(grid[8][64], CellType::ORC);
+    EXPECT_EQ(grid.get(63, 8), CellType::EMPTY);
+    EXPECT_EQ(grid.size(), 37u);
+    EXPECT_EQ(grid[0].size(), 100u);
+  }
+}
+
+TEST(GridTest, AStarFindsSamePathInEveryLayout) {
+  // Arrange
+  auto isNavigable = [](CellType cell) { return cell != CellType::WALL; };
+  std::deque<Point> reference;
+
+  for (auto layout : layouts) {
+    Grid grid(20, 20, layout);
+    for (int y = 0; y < 19; ++y) {
+      grid.set(10, y, CellType::WALL);
+    }
+
+    // Act
+    AStar<CellType, Grid> aStar(grid, Point(0, 0), Point(19, 0), isNavigable);
+    auto path = aStar.getPath();
+
+    // Assert
+    ASSERT_EQ(path.size(), 1u + 19u + 19u * 2u) << gridLayoutName(layout);
+    if (reference.empty()) {
+      reference = path;
+    }
+    EXPECT_EQ(path, reference) << gridLayoutName(layout);
+  }
+}
+
+TEST(GridTest, PackedStorageUsesHalfTheBytes) {
+  // Arrange & Act
+  Grid bytes(101, 7, GridLayout::ROW_MAJOR, GridStorage::BYTE);
+  Grid packed(101, 7, GridLayout::ROW_MAJOR, GridStorage::PACKED);
+
+  // Assert
+  EXPECT_EQ(bytes.getBytes(), 707u);
+  EXPECT_EQ(packed.getBytes(), 357u); // rows padded to 102 cells
+}
+
+TEST(GridTest, PackedCellsDoNotOverwriteTheirNeighbours) {
+  for (auto layout : layouts) {
+    // Arrange
+    Grid grid(33, 9, layout, GridStorage::PACKED, CellType::WALL);
+
+    // Act
+    grid.set(4, 3, CellType::END);
+    grid.set(5, 3, CellType::DRAGON);
+    grid.set(4, 3, CellType::EMPTY);
+
+    // Assert
+    EXPECT_EQ(grid.get(4, 3), CellType::EMPTY) << gridLayoutName(layout);
+    EXPECT_EQ(grid.get(5, 3), CellType::DRAGON) << gridLayoutName(layout);
+    EXPECT_EQ(grid.get(3, 3), CellType::WALL) << gridLayoutName(layout);
+    EXPECT_EQ(grid.get(4, 4), CellType::WALL) << gridLayoutName(layout);
+  }
+}
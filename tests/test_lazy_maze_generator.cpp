@@ -0,0 +1,118 @@
+#include "algorithms/lazy_maze_generator.h"
+#include "algorithms/maze_generator.h"
+#include "model/map.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <queue>
+
+namespace {
+// Passages reachable from the start, four directions at a time
+size_t reachableFromStart(const std::vector<std::string> &maze,
+                          std::pair<unsigned int, unsigned int> start) {
+  std::vector<std::string> seen = maze;
+  std::queue<std::pair<unsigned int, unsigned int>> frontier;
+  frontier.push(start);
+  seen[start.second][start.first] = '.';
+  size_t reached = 0;
+  while (!frontier.empty()) {
+    auto [x, y] = frontier.front();
+    frontier.pop();
+    ++reached;
+    const std::pair<int, int> steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (auto [dx, dy] : steps) {
+      auto &cell = seen[y + dy][x + dx];
+      if (cell == ' ') {
+        cell = '.';
+        frontier.push({x + dx, y + dy});
+      }
+    }
+  }
+  return reached;
+}
+
+size_t passages(const std::vector<std::string> &maze) {
+  size_t count = 0;
+  for (const auto &row : maze) {
+    count += std::count(row.begin(), row.end(), ' ');
+  }
+  return count;
+}
+} // namespace
+
+TEST(LazyMazeGeneratorTest, GeneratesTheSameMazeInPieces) {
+  // Arrange
+  LazyMazeGenerator whole(51, 40, 3);
+  LazyMazeGenerator pieces(51, 40, 3);
+
+  // Act
+  auto expected = whole.generateRows(40);
+  std::vector<std::string> generated;
+  for (unsigned int rows = 3; !pieces.isFinished(); rows += 7) {
+    for (auto &row : pieces.generateRows(rows)) {
+      generated.push_back(row);
+    }
+  }
+
+  // Assert
+  EXPECT_EQ(generated, expected);
+  EXPECT_EQ(MazeGenerator(51, 40, MazeGeneratorAlgorithm::Ellers, 3).getMaze(),
+            expected);
+}
+
+TEST(LazyMazeGeneratorTest, ConnectsEveryPassageToTheStart) {
+  for (auto [width, height] : {std::pair<unsigned int, unsigned int>{31, 21},
+                               {100, 100},
+                               {40, 17}}) {
+    // Arrange
+    LazyMazeGenerator generator(width, height, width * height);
+
+    // Act
+    auto maze = generator.generateRows(height);
+    auto [endX, endY] = generator.getEnd();
+
+    // Assert
+    ASSERT_EQ(maze.size(), height);
+    EXPECT_EQ(maze[endY][endX], ' ');
+    EXPECT_EQ(reachableFromStart(maze, generator.getStart()), passages(maze));
+    EXPECT_EQ(maze.front(), std::string(width, '#'));
+    EXPECT_EQ(maze.back(), std::string(width, '#'));
+  }
+}
+
+TEST(LazyMazeGeneratorTest, MapRevealsRowsOnDemand) {
+  // Arrange
+  Map map(60, 50);
+  map.loadLazyLevel(9);
+
+  // Act
+  map.revealRows(12);
+  Map copy(map);
+  map.revealRows(50);
+  copy.revealRows(30);
+  copy.revealRows(50);
+
+  // Assert
+  EXPECT_TRUE(map.isFullyGenerated());
+  EXPECT_EQ(map.hash.get(), copy.hash.get());
+  EXPECT_EQ(map.hash.get(), map.computeHash());
+  EXPECT_NE(map.exitDistance(map.getStart()), Map::unreachable);
+}
+
+TEST(LazyMazeGeneratorTest, UnrevealedRowsAreWalls) {
+  // Arrange
+  Map map(60, 50);
+  map.loadLazyLevel(9);
+
+  // Act
+  map.revealRows(12);
+
+  // Assert
+  EXPECT_FALSE(map.isFullyGenerated());
+  EXPECT_EQ(map.getCellType(map.getStart()), CellType::EMPTY);
+  EXPECT_EQ(map.exitDistance(map.getStart()), Map::unreachable);
+  for (unsigned int y = 12; y < 50; ++y) {
+    for (unsigned int x = 0; x < 60; ++x) {
+      ASSERT_EQ(map.getCellType(Point(x, y)), CellType::WALL);
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include "model/level_cache.h"
+#include "utils/metrics.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+LevelKey makeKey(unsigned int seed) {
+  LevelKey key;
+  key.seed = seed;
+  key.width = 41;
+  key.height = 31;
+  return key;
+}
+
+std::string makeDirectory(const std::string &name) {
+  auto directory = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(directory);
+  return directory.string();
+}
+
+uint64_t counterValue(const std::string &name) {
+  return MetricsRegistry::getInstance().counter(name, "").get();
+}
+} // namespace
+
+TEST(LevelCacheTest, SameKeyGivesTheSameLevel) {
+  // Arrange
+  LevelCache cache(4);
+
+  // Act
+  auto first = cache.get(makeKey(7));
+  auto again = cache.get(makeKey(7));
+  auto other = cache.get(makeKey(8));
+  LevelCache freshCache(4);
+  auto regenerated = freshCache.get(makeKey(7));
+
+  // Assert
+  EXPECT_EQ(first, again);
+  EXPECT_EQ(first->cells, regenerated->cells);
+  EXPECT_EQ(*first->exitDistances, *regenerated->exitDistances);
+  EXPECT_NE(first->cells, other->cells);
+  EXPECT_NE(makeKey(7).digest(), makeKey(8).digest());
+}
+
+TEST(LevelCacheTest, EvictsTheLeastRecentlyUsedLevel) {
+  // Arrange
+  LevelCache cache(2);
+  auto first = cache.get(makeKey(1));
+  auto second = cache.get(makeKey(2));
+
+  // Act
+  cache.get(makeKey(1));
+  cache.get(makeKey(3));
+
+  // Assert
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.get(makeKey(1)), first);
+  EXPECT_NE(cache.get(makeKey(2)), second);
+}
+
+TEST(LevelCacheTest, ReadsLevelsWrittenByAnotherCache) {
+  // Arrange
+  auto directory = makeDirectory("md_level_cache_test");
+  auto written = LevelCache(4, directory).get(makeKey(11));
+  auto diskHits = counterValue("md_level_cache_disk_hits_total");
+
+  // Act
+  LevelCache cache(4, directory);
+  auto read = cache.get(makeKey(11));
+  Map map(*read);
+
+  // Assert
+  EXPECT_EQ(counterValue("md_level_cache_disk_hits_total"), diskHits + 1);
+  EXPECT_EQ(read->cells, written->cells);
+  EXPECT_EQ(*read->exitDistances, *written->exitDistances);
+  EXPECT_EQ(read->start, written->start);
+  EXPECT_EQ(read->end, written->end);
+  EXPECT_EQ(map.hash.get(), map.computeHash());
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LevelCacheTest, RegeneratesDamagedFiles) {
+  // Arrange
+  auto directory = makeDirectory("md_level_cache_damaged_test");
+  LevelCache writer(4, directory);
+  auto written = writer.get(makeKey(12));
+  std::filesystem::resize_file(writer.pathOf(makeKey(12)), 100);
+  auto diskHits = counterValue("md_level_cache_disk_hits_total");
+
+  // Act
+  auto read = LevelCache(4, directory).get(makeKey(12));
+
+  // Assert
+  EXPECT_EQ(counterValue("md_level_cache_disk_hits_total"), diskHits);
+  EXPECT_EQ(read->cells, written->cells);
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LevelCacheTest, KeepsTheRoomsOfRoomLevels) {
+  // Arrange
+  auto directory = makeDirectory("md_level_cache_rooms_test");
+  auto key = makeKey(13);
+  key.algorithm = MazeGeneratorAlgorithm::BspRooms;
+  auto written = LevelCache(4, directory).get(key);
+
+  // Act
+  auto read = LevelCache(4, directory).get(key);
+
+  // Assert
+  ASSERT_NE(written->roomGraph, nullptr);
+  ASSERT_NE(read->roomGraph, nullptr);
+  ASSERT_EQ(read->roomGraph->getRooms().size(),
+            written->roomGraph->getRooms().size());
+  EXPECT_EQ(read->roomGraph->getDoors().size(),
+            written->roomGraph->getDoors().size());
+  EXPECT_EQ(read->roomGraph->route(read->start, read->end),
+            written->roomGraph->route(written->start, written->end));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LevelCacheTest, ExitDistancesLeadToTheExit) {
+  // Arrange
+  Map map(*LevelCache(1).get(makeKey(5)));
+  const Point steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+  // Act & Assert
+  EXPECT_EQ(map.exitDistance(map.getEnd()), 0u);
+  EXPECT_NE(map.exitDistance(map.getStart()), Map::unreachable);
+  EXPECT_EQ(map.exitDistance(Point(-1, 0)), Map::unreachable);
+  for (unsigned int y = 0; y < map.getHeight(); ++y) {
+    for (unsigned int x = 0; x < map.getWidth(); ++x) {
+      Point point(x, y);
+      auto distance = map.exitDistance(point);
+      if (map.getCellType(point) == CellType::WALL) {
+        ASSERT_EQ(distance, Map::unreachable);
+      } else if (distance != 0 && distance != Map::unreachable) {
+        // Some neighbour is one step closer
+        bool closer = false;
+        for (const auto &step : steps) {
+          closer |= map.exitDistance(point + step) == distance - 1;
+        }
+        ASSERT_TRUE(closer);
+      }
+    }
+  }
+}
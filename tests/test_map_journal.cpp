@@ -0,0 +1,142 @@
+#include "model/map.h"
+#include "model/map_journal.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+namespace {
+std::vector<CellChange> drainAll(MapJournal &journal,
+                                 MapJournal::SubscriberId id,
+                                 bool *complete = nullptr) {
+  std::vector<CellChange> drained;
+  bool result = journal.drain(
+      id, [&](const CellChange &change) { drained.push_back(change); });
+  if (complete) {
+    *complete = result;
+  }
+  return drained;
+}
+} // namespace
+
+TEST(MapJournalTest, ReplaysChangesAfterInitialRebuild) {
+  // Arrange
+  MapJournal journal;
+  auto id = journal.subscribe();
+  bool complete = true;
+
+  // Act
+  drainAll(journal, id, &complete);
+  journal.record(Point(1, 2), CellType::EMPTY, CellType::ORC);
+  journal.record(Point(1, 3), CellType::ORC, CellType::EMPTY);
+  auto changes = drainAll(journal, id);
+
+  // Assert
+  EXPECT_FALSE(complete);
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].point, Point(1, 2));
+  EXPECT_EQ(changes[0].newType, CellType::ORC);
+  EXPECT_EQ(changes[1].oldType, CellType::ORC);
+  EXPECT_TRUE(drainAll(journal, id).empty());
+}
+
+TEST(MapJournalTest, ResetTellsSubscribersToRebuild) {
+  // Arrange
+  MapJournal journal;
+  auto id = journal.subscribe();
+  drainAll(journal, id);
+  journal.record(Point(0, 0), CellType::EMPTY, CellType::WALL);
+
+  // Act
+  journal.reset();
+  bool complete = true;
+  auto changes = drainAll(journal, id, &complete);
+
+  // Assert
+  EXPECT_FALSE(complete);
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST(MapJournalTest, NextTickKeepsChangesOfSlowSubscribers) {
+  // Arrange
+  MapJournal journal;
+  auto fast = journal.subscribe();
+  auto slow = journal.subscribe();
+  drainAll(journal, fast);
+  drainAll(journal, slow);
+  journal.record(Point(4, 4), CellType::EMPTY, CellType::TREASURE);
+
+  // Act
+  drainAll(journal, fast);
+  journal.nextTick();
+  auto sizeWithSlowSubscriber = journal.size();
+  auto slowChanges = drainAll(journal, slow);
+  journal.nextTick();
+
+  // Assert
+  EXPECT_EQ(sizeWithSlowSubscriber, 1u);
+  EXPECT_EQ(slowChanges.size(), 1u);
+  EXPECT_EQ(journal.size(), 0u);
+  EXPECT_EQ(journal.getTick(), 2u);
+}
+
+TEST(MapJournalTest, OverflowTurnsIntoReset) {
+  // Arrange
+  MapJournal journal(4);
+  auto id = journal.subscribe();
+  drainAll(journal, id);
+
+  // Act
+  for (int i = 0; i < 6; ++i) {
+    journal.record(Point(i, 0), CellType::EMPTY, CellType::WALL);
+  }
+  bool complete = true;
+  drainAll(journal, id, &complete);
+
+  // Assert
+  EXPECT_FALSE(complete);
+  EXPECT_EQ(journal.size(), 2u);
+}
+
+TEST(MapJournalTest, MapRecordsOnlyActualChanges) {
+  // Arrange
+  Map map(21, 21);
+  map.loadLevel();
+  auto id = map.journal.subscribe();
+  drainAll(map.journal, id);
+  auto position = map.randomFreePosition();
+
+  // Act
+  map.setCellType(position, CellType::GOBLIN);
+  map.setCellType(position, CellType::GOBLIN);
+  map.setCellType(Point(-1, 0), CellType::GOBLIN);
+  auto changes = drainAll(map.journal, id);
+
+  // Assert
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].point, position);
+  EXPECT_EQ(changes[0].oldType, CellType::EMPTY);
+  EXPECT_EQ(changes[0].newType, CellType::GOBLIN);
+}
+
+TEST(MapJournalTest, StagedChangesAreAppendedInOrder) {
+  // Arrange
+  MapJournal journal;
+  auto id = journal.subscribe();
+  drainAll(journal, id);
+  std::vector<CellChange> staged;
+
+  // Act
+  {
+    MapJournal::StagingScope scope(staged);
+    journal.record(Point(5, 5), CellType::EMPTY, CellType::TROLL);
+  }
+  journal.record(Point(1, 1), CellType::EMPTY, CellType::WALL);
+  auto sizeBeforeAppend = journal.size();
+  journal.append(staged);
+  auto changes = drainAll(journal, id);
+
+  // Assert
+  EXPECT_EQ(staged.size(), 1u);
+  EXPECT_EQ(sizeBeforeAppend, 1u);
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[1].point, Point(5, 5));
+}
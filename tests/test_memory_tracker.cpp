@@ -0,0 +1,40 @@
+#include "utils/memory_tracker.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(MemoryTrackerTest, TracksLiveBytesAndHighWaterMark) {
+  // Arrange
+  auto &tracker = MemoryTracker::getInstance();
+  auto liveBefore = tracker.getLiveBytes(MemoryTag::PATHFINDING);
+
+  // Act
+  {
+    std::vector<int, TrackingAllocator<int, MemoryTag::PATHFINDING>> values;
+    values.reserve(1000);
+
+    // Assert
+    ASSERT_EQ(tracker.getLiveBytes(MemoryTag::PATHFINDING),
+              liveBefore + 1000 * sizeof(int));
+    ASSERT_GE(tracker.getPeakBytes(MemoryTag::PATHFINDING),
+              liveBefore + 1000 * sizeof(int));
+  }
+
+  ASSERT_EQ(tracker.getLiveBytes(MemoryTag::PATHFINDING), liveBefore);
+  ASSERT_GE(tracker.getPeakBytes(MemoryTag::PATHFINDING),
+            liveBefore + 1000 * sizeof(int));
+}
+
+TEST(MemoryTrackerTest, MakeTrackedAccountsObjectToTag) {
+  // Arrange
+  auto &tracker = MemoryTracker::getInstance();
+  auto liveBefore = tracker.getLiveBytes(MemoryTag::ENTITIES);
+
+  // Act
+  auto value = makeTracked<MemoryTag::ENTITIES, long double>(1.0L);
+
+  // Assert
+  ASSERT_GE(tracker.getLiveBytes(MemoryTag::ENTITIES),
+            liveBefore + sizeof(long double));
+  value.reset();
+  ASSERT_EQ(tracker.getLiveBytes(MemoryTag::ENTITIES), liveBefore);
+}
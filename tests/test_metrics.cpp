@@ -0,0 +1,55 @@
+#include "utils/metrics.h"
+#include "gtest/gtest.h"
+
+TEST(HistogramTest, BucketsCoverValuesContiguously) {
+  // Arrange
+  int previousIndex = Histogram::bucketIndex(0);
+
+  // Act & Assert
+  for (uint64_t value = 1; value < 4096; ++value) {
+    int index = Histogram::bucketIndex(value);
+    ASSERT_TRUE(index == previousIndex || index == previousIndex + 1);
+    ASSERT_LE(Histogram::bucketLowerBound(index), value);
+    previousIndex = index;
+  }
+  ASSERT_LT(Histogram::bucketIndex(UINT64_MAX), Histogram::bucketCount);
+}
+
+TEST(HistogramTest, PercentilesStayWithinRelativeError) {
+  // Arrange
+  Histogram histogram;
+
+  // Act
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+
+  // Assert
+  ASSERT_EQ(histogram.getCount(), 1000u);
+  ASSERT_NEAR(static_cast<double>(histogram.percentile(50)), 500.0,
+              500 * 0.125);
+  ASSERT_NEAR(static_cast<double>(histogram.percentile(99)), 990.0,
+              990 * 0.125);
+  ASSERT_EQ(histogram.countBelowPowerOfTwo(9), 511u);
+}
+
+TEST(MetricsRegistryTest, ExportsPrometheusText) {
+  // Arrange
+  auto &registry = MetricsRegistry::getInstance();
+  registry.counter("md_test_events_total", "Test events").increment(3);
+  registry.gauge("md_test_level", "Test level").set(-2);
+  registry.histogram("md_test_latency_seconds", "Test latency", 1e-9)
+      .record(1500);
+
+  // Act
+  auto text = registry.exportPrometheus();
+
+  // Assert
+  ASSERT_NE(text.find("# TYPE md_test_events_total counter"),
+            std::string::npos);
+  ASSERT_NE(text.find("md_test_events_total 3"), std::string::npos);
+  ASSERT_NE(text.find("md_test_level -2"), std::string::npos);
+  ASSERT_NE(text.find("md_test_latency_seconds_bucket{le=\"+Inf\"} 1"),
+            std::string::npos);
+  ASSERT_NE(text.find("md_test_latency_seconds_count 1"), std::string::npos);
+}
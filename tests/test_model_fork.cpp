@@ -0,0 +1,58 @@
+#include "model/model.h"
+#include "utils/direction.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+namespace {
+// Walks the local player around, blocked moves are fine
+void walk(Model &model, int steps) {
+  const Point directions[] = {Direction::RIGHT, Direction::DOWN,
+                              Direction::LEFT, Direction::UP};
+  for (int i = 0; i < steps; ++i) {
+    model.queuePlayerMove(directions[(i / 3) % 4]);
+    model.step();
+  }
+}
+} // namespace
+
+TEST(ModelForkTest, StartsEqualAndStaysIndependent) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto hash = model.stateHash();
+  auto position = model.player->position;
+
+  // Act
+  auto fork = model.fork();
+  auto forkHash = fork->stateHash();
+  auto forkMonsters = fork->monsters.size();
+  walk(*fork, 30);
+
+  // Assert
+  EXPECT_EQ(forkHash, hash);
+  EXPECT_NE(fork->map, model.map);
+  EXPECT_NE(fork->player, model.player);
+  EXPECT_EQ(forkMonsters, model.monsters.size());
+  EXPECT_EQ(model.stateHash(), hash);
+  EXPECT_EQ(model.computeStateHash(), hash);
+  EXPECT_EQ(model.player->position, position);
+  EXPECT_EQ(fork->stateHash(), fork->computeStateHash());
+}
+
+TEST(ModelForkTest, ForksOfOneStatePlayOutTheSame) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto first = model.fork();
+  auto second = model.fork();
+
+  // Act
+  walk(*first, 40);
+  walk(*second, 40);
+
+  // Assert
+  EXPECT_EQ(first->stateHash(), second->stateHash());
+  EXPECT_EQ(first->player->position, second->player->position);
+  EXPECT_EQ(first->player->health, second->player->health);
+  EXPECT_EQ(first->monsters.size(), second->monsters.size());
+}
@@ -0,0 +1,170 @@
+#include "model/model.h"
+#include "utils/direction.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+// Joins a remote player and returns it once the join was applied
+std::shared_ptr<Player> join(Model &model) {
+  auto id = model.commands.reservePlayerId();
+  model.commands.submit(CommandType::JOIN, id);
+  model.step();
+  for (const auto &other : model.players) {
+    if (other->id == id) {
+      return other;
+    }
+  }
+  return nullptr;
+}
+
+// Free cell a few steps away from point, joined to it by free cells
+std::optional<Point> freeCellNear(const Map &map, const Point &point) {
+  std::vector<Point> reached{point};
+  std::optional<Point> farthest;
+  for (size_t next = 0; next < reached.size() && reached.size() < 6; ++next) {
+    for (const auto &step : {Direction::UP, Direction::DOWN, Direction::LEFT,
+                             Direction::RIGHT}) {
+      auto cell = reached[next] + step;
+      if (map.isPositionFree(cell) &&
+          std::find(reached.begin(), reached.end(), cell) == reached.end()) {
+        reached.push_back(cell);
+        farthest = cell;
+      }
+    }
+  }
+  return farthest;
+}
+} // namespace
+
+TEST(ModelPlayersTest, JoiningPlayersAreAddedToTheMap) {
+  // Arrange
+  Model model;
+  model.restart();
+
+  // Act
+  auto remote = join(model);
+
+  // Assert
+  ASSERT_NE(remote, nullptr);
+  EXPECT_EQ(model.players.size(), 2u);
+  EXPECT_EQ(model.players.front(), model.player);
+  EXPECT_TRUE(remote->isAlive());
+  EXPECT_EQ(model.map->getCellType(remote->position), CellType::PLAYER);
+  EXPECT_TRUE(model.hasRemotePlayers());
+  EXPECT_EQ(model.stateHash(), model.computeStateHash());
+}
+
+TEST(ModelPlayersTest, LeavingPlayersAreRemovedButNotTheLocalOne) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto remote = join(model);
+  ASSERT_NE(remote, nullptr);
+  auto position = remote->position;
+
+  // Act
+  model.commands.submit(CommandType::LEAVE, remote->id);
+  model.commands.submit(CommandType::LEAVE, CommandBuffer::localPlayerId);
+  model.step();
+
+  // Assert
+  ASSERT_EQ(model.players.size(), 1u);
+  EXPECT_EQ(model.players.front(), model.player);
+  EXPECT_NE(model.map->getCellType(position), CellType::PLAYER);
+  EXPECT_FALSE(model.hasRemotePlayers());
+  EXPECT_EQ(model.stateHash(), model.computeStateHash());
+}
+
+TEST(ModelPlayersTest, AppliesMovesOfRemotePlayers) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto remote = join(model);
+  ASSERT_NE(remote, nullptr);
+  std::optional<Point> direction;
+  for (const auto &step : {Direction::UP, Direction::DOWN, Direction::LEFT,
+                           Direction::RIGHT}) {
+    if (!direction && model.map->isPositionFree(remote->position + step)) {
+      direction = step;
+    }
+  }
+  ASSERT_TRUE(direction.has_value());
+  auto target = remote->position + *direction;
+
+  // Act
+  model.commands.submit(CommandType::MOVE, remote->id, *direction);
+  model.step();
+
+  // Assert
+  EXPECT_EQ(remote->position, target);
+  EXPECT_EQ(model.map->getCellType(target), CellType::PLAYER);
+  EXPECT_EQ(model.stateHash(), model.computeStateHash());
+}
+
+TEST(ModelPlayersTest, PublishesTheSurroundingsOfSocketClients) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto remote = join(model);
+  ASSERT_NE(remote, nullptr);
+  uint64_t version = 0;
+  std::string view;
+
+  // Act
+  auto published = model.views.takeNewer(remote->id, version, view);
+  remote->takeDamage(remote->health);
+  model.step();
+  std::string defeated;
+  model.views.takeNewer(remote->id, version, defeated);
+
+  // Assert
+  ASSERT_TRUE(published);
+  EXPECT_NE(view.find("Health " + std::to_string(remote->getMaxHealth())),
+            std::string::npos);
+  EXPECT_NE(view.find("Position " + std::to_string(remote->position.x) +
+                      "," + std::to_string(remote->position.y)),
+            std::string::npos);
+  // Status line, 15 rows of 15 cells around the player, an empty line
+  auto rows = view.substr(view.find('\n') + 1);
+  ASSERT_EQ(rows.size(), 15u * 16 + 1);
+  EXPECT_EQ(rows[7 * 16 + 7], '@');
+  EXPECT_EQ(defeated, remote->toString() + " was defeated.\n\n");
+}
+
+TEST(ModelPlayersTest, OrcsHuntTheNearestLivingPlayer) {
+  // Arrange
+  Model model;
+  model.restart();
+  auto remote = join(model);
+  ASSERT_NE(remote, nullptr);
+  model.player->takeDamage(model.player->health);
+  auto start = freeCellNear(*model.map, remote->position);
+  ASSERT_TRUE(start.has_value());
+  auto scheduler = std::make_shared<PathScheduler>();
+  auto orc = std::make_shared<Orc>(
+      model.map,
+      [&model](const Point &point) { return model.nearestPlayer(point); },
+      scheduler);
+  orc->move(*start);
+
+  // Act
+  orc->randomizeVelocity();
+  while (scheduler->pending() > 0) {
+    scheduler->run(orc->position);
+  }
+  auto position = orc->position;
+  while (orc->followsPath()) {
+    position = position + orc->getVelocity();
+    orc->position = position;
+  }
+
+  // Assert
+  EXPECT_TRUE(model.isGameOver());
+  EXPECT_EQ(model.nearestPlayer(model.player->position), remote);
+  EXPECT_EQ(position, remote->position);
+}
@@ -0,0 +1,183 @@
+#include "model/path_scheduler.h"
+#include "support/walker_world.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+
+namespace {
+using Search = AStar<CellType, Grid>;
+
+bool isEmpty(CellType cell) { return cell == CellType::EMPTY; }
+} // namespace
+
+TEST(PathSchedulerTest, SteppedSearchMatchesOneShotSearch) {
+  // Arrange
+  auto map = openMap(30, 30);
+  for (int y = 0; y < 29; ++y) {
+    map->grid.set(15, y, CellType::WALL);
+  }
+  Search oneShot(map->grid, Point(0, 0), Point(29, 0), isEmpty);
+  Search stepped(isEmpty);
+
+  // Act
+  stepped.begin(map->grid, Point(0, 0), Point(29, 0));
+  int steps = 0;
+  while (stepped.step(10) == Search::Status::SEARCHING) {
+    ++steps;
+  }
+
+  // Assert
+  EXPECT_GT(steps, 1);
+  EXPECT_EQ(stepped.getStatus(), Search::Status::FOUND);
+  EXPECT_EQ(stepped.getPath(), oneShot.getPath());
+}
+
+TEST(PathSchedulerTest, NeverExceedsTickBudget) {
+  // Arrange
+  auto map = openMap(24, 24);
+  PathScheduler scheduler(50);
+  int delivered = 0;
+  for (int i = 0; i < 10; ++i) {
+    scheduler.request(map, Point(i, 0), Point(23, 23), isEmpty,
+                      [&delivered](PathScheduler::Path path) {
+                        EXPECT_FALSE(path.empty());
+                        ++delivered;
+                      });
+  }
+
+  // Act & Assert
+  int ticks = 0;
+  while (scheduler.pending() > 0 && ticks < 1000) {
+    EXPECT_LE(scheduler.run(Point(0, 0)), 50u);
+    ++ticks;
+  }
+  EXPECT_EQ(delivered, 10);
+  EXPECT_GT(ticks, 10);
+}
+
+TEST(PathSchedulerTest, SearchesCloseToFocusFinishFirst) {
+  // Arrange
+  auto map = openMap(64, 64);
+  PathScheduler scheduler(40);
+  std::vector<int> order;
+  scheduler.request(map, Point(60, 60), Point(40, 40), isEmpty,
+                    [&order](PathScheduler::Path) { order.push_back(1); });
+  scheduler.request(map, Point(2, 2), Point(22, 22), isEmpty,
+                    [&order](PathScheduler::Path) { order.push_back(2); });
+
+  // Act
+  while (scheduler.pending() > 0) {
+    scheduler.run(Point(0, 0));
+  }
+
+  // Assert
+  EXPECT_EQ(order, (std::vector<int>{2, 1}));
+}
+
+TEST(PathSchedulerTest, AbandonsSearchesOverExpansionLimit) {
+  // Arrange
+  auto map = openMap(64, 64);
+  for (int y = 0; y < 64; ++y) {
+    map->grid.set(32, y, CellType::WALL);
+  }
+  PathScheduler scheduler(100, 300);
+  bool delivered = false;
+  scheduler.request(map, Point(0, 0), Point(63, 0), isEmpty,
+                    [&delivered](PathScheduler::Path path) {
+                      EXPECT_TRUE(path.empty());
+                      delivered = true;
+                    });
+
+  // Act
+  for (int tick = 0; tick < 4; ++tick) {
+    scheduler.run(Point(0, 0));
+  }
+
+  // Assert
+  EXPECT_TRUE(delivered);
+  EXPECT_EQ(scheduler.pending(), 0u);
+}
+
+TEST(PathSchedulerTest, ClearCompletesPendingSearchesWithEmptyPaths) {
+  // Arrange
+  auto map = openMap(16, 16);
+  PathScheduler scheduler;
+  int cleared = 0;
+  auto id = scheduler.request(map, Point(0, 0), Point(15, 15), isEmpty,
+                              [](PathScheduler::Path) { FAIL(); });
+  scheduler.request(map, Point(0, 0), Point(15, 15), isEmpty,
+                    [&cleared](PathScheduler::Path path) {
+                      EXPECT_TRUE(path.empty());
+                      ++cleared;
+                    });
+
+  // Act
+  scheduler.cancel(id);
+  scheduler.clear();
+
+  // Assert
+  EXPECT_EQ(cleared, 1);
+  EXPECT_EQ(scheduler.pending(), 0u);
+}
+
+TEST(PathSchedulerTest, SearchesBetweenRoomsGoThroughTheirDoors) {
+  // Arrange
+  auto map = std::make_shared<Map>(120, 80);
+  map->loadLevel(21, MazeGeneratorAlgorithm::BspRooms);
+  auto rooms = map->getRoomGraph();
+  ASSERT_NE(rooms, nullptr);
+  auto from = map->getStart();
+  auto to = map->getEnd();
+  auto doors = rooms->route(from, to);
+  PathScheduler scheduler(100000, 100000);
+  PathScheduler::Path path;
+  scheduler.request(map, from, to, isEmpty,
+                    [&path](PathScheduler::Path found) { path = found; });
+
+  // Act
+  scheduler.run(from);
+
+  // Assert
+  ASSERT_FALSE(doors.empty());
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.front(), from);
+  EXPECT_EQ(path.back(), to);
+  for (size_t i = 1; i < path.size(); ++i) {
+    auto step = path[i] - path[i - 1];
+    ASSERT_EQ(std::abs(step.x) + std::abs(step.y), 1);
+    ASSERT_TRUE(isEmpty(map->getCellType(path[i])));
+  }
+  auto door = doors.begin();
+  for (const auto &point : path) {
+    if (door != doors.end() && point == *door) {
+      ++door;
+    }
+  }
+  EXPECT_EQ(door, doors.end());
+}
+
+TEST(PathSchedulerTest, SkipsSearchesForWalledOffGoals) {
+  // Arrange
+  auto open = openMap(64, 64);
+  for (int y = 0; y < 64; ++y) {
+    open->grid.set(32, y, CellType::WALL);
+  }
+  // Unpacking labels the areas on both sides of the wall
+  auto map = std::make_shared<Map>(open->pack());
+  PathScheduler scheduler(100, 100000);
+  bool delivered = false;
+  scheduler.request(map, Point(0, 0), Point(63, 0), isEmpty,
+                    [&delivered](PathScheduler::Path path) {
+                      EXPECT_TRUE(path.empty());
+                      delivered = true;
+                    });
+
+  // Act
+  auto spent = scheduler.run(Point(0, 0));
+
+  // Assert
+  EXPECT_TRUE(delivered);
+  EXPECT_EQ(spent, 0u);
+  EXPECT_FALSE(map->isReachable(Point(0, 0), Point(63, 0)));
+  EXPECT_TRUE(map->isReachable(Point(0, 0), Point(31, 63)));
+}
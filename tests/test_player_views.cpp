@@ -0,0 +1,45 @@
+#include "model/player_views.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <string>
+
+TEST(PlayerViewsTest, HandsOutOnlyNewerViews) {
+  // Arrange
+  PlayerViews views;
+  uint64_t version = 0;
+  std::string view;
+
+  // Act
+  views.publish(3, "first");
+  auto first = views.takeNewer(3, version, view);
+  auto again = views.takeNewer(3, version, view);
+  views.publish(3, "first");
+  auto unchanged = views.takeNewer(3, version, view);
+  views.publish(3, "second");
+  views.publish(3, "third");
+  auto latest = views.takeNewer(3, version, view);
+
+  // Assert
+  EXPECT_TRUE(first);
+  EXPECT_FALSE(again);
+  EXPECT_FALSE(unchanged);
+  EXPECT_TRUE(latest);
+  EXPECT_EQ(view, "third");
+}
+
+TEST(PlayerViewsTest, ForgetsRemovedPlayers) {
+  // Arrange
+  PlayerViews views;
+  uint64_t version = 0;
+  std::string view;
+  views.publish(3, "view");
+  views.publish(4, "other");
+
+  // Act
+  views.remove(3);
+
+  // Assert
+  EXPECT_FALSE(views.takeNewer(3, version, view));
+  EXPECT_TRUE(views.takeNewer(4, version, view));
+  EXPECT_EQ(view, "other");
+}
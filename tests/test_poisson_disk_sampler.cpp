@@ -0,0 +1,86 @@
+#include "algorithms/poisson_disk_sampler.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+namespace {
+// Every third column is a wall, like the corridors of a maze
+bool isCorridor(const Point &point) { return point.x % 3 != 2; }
+
+double closestPair(const std::vector<Point> &points) {
+  double closest = 1e9;
+  for (size_t i = 0; i < points.size(); ++i) {
+    for (size_t j = i + 1; j < points.size(); ++j) {
+      closest = std::min(closest, points[i].distance(points[j]));
+    }
+  }
+  return closest;
+}
+} // namespace
+
+TEST(PoissonDiskSamplerTest, KeepsPointsApartOnFreeCells) {
+  // Arrange
+  PoissonDiskSampler sampler(120, 90, isCorridor, 3);
+
+  // Act
+  auto points = sampler.sample(200, 5);
+
+  // Assert
+  ASSERT_EQ(points.size(), 200u);
+  EXPECT_GE(closestPair(points), 5);
+  for (const auto &point : points) {
+    EXPECT_TRUE(isCorridor(point));
+    EXPECT_TRUE(point.x >= 0 && point.x < 120 && point.y >= 0 &&
+                point.y < 90);
+  }
+}
+
+TEST(PoissonDiskSamplerTest, FillsAreasTheCandidatesCannotJumpTo) {
+  // Arrange
+  // Two open areas with 40 columns of wall between them
+  auto isFree = [](const Point &point) {
+    return point.x < 20 || point.x >= 60;
+  };
+  PoissonDiskSampler sampler(80, 20, isFree, 9);
+
+  // Act
+  auto points = sampler.sample(1000, 4);
+
+  // Assert
+  size_t left = 0;
+  for (const auto &point : points) {
+    left += point.x < 20;
+  }
+  EXPECT_GT(left, 0u);
+  EXPECT_LT(left, points.size());
+  EXPECT_GE(closestPair(points), 4);
+}
+
+TEST(PoissonDiskSamplerTest, ReturnsWhatFitsWhenTheLevelIsFull) {
+  // Arrange
+  PoissonDiskSampler sampler(10, 10, [](const Point &) { return true; }, 1);
+
+  // Act
+  auto points = sampler.sample(100, 6);
+  auto none = sampler.sample(100, 0);
+
+  // Assert
+  EXPECT_GE(points.size(), 1u);
+  EXPECT_LT(points.size(), 100u);
+  EXPECT_GE(closestPair(points), 6);
+  EXPECT_TRUE(none.empty());
+}
+
+TEST(PoissonDiskSamplerTest, SameSeedGivesTheSamePoints) {
+  // Arrange
+  PoissonDiskSampler first(64, 64, isCorridor, 5);
+  PoissonDiskSampler second(64, 64, isCorridor, 5);
+  PoissonDiskSampler other(64, 64, isCorridor, 6);
+
+  // Act
+  auto points = first.sample(50, 3);
+
+  // Assert
+  EXPECT_EQ(points, second.sample(50, 3));
+  EXPECT_NE(points, other.sample(50, 3));
+  EXPECT_EQ(points.size(), 50u);
+}
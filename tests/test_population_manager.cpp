@@ -0,0 +1,125 @@
+#include "model/population_manager.h"
+#include "support/walker_world.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+namespace {
+std::shared_ptr<Monster> goblinAt(const Point &position) {
+  auto goblin = std::make_shared<Goblin>();
+  goblin->position = position;
+  return goblin;
+}
+
+void kill(const std::shared_ptr<Monster> &monster) {
+  monster->takeDamage(monster->health);
+}
+} // namespace
+
+TEST(PopulationManagerTest, ReusesTheDeadInTheirRegion) {
+  // Arrange
+  auto map = openMap(64, 64);
+  PopulationManager population(32, 10, 1, 5);
+  MonsterList monsters = {goblinAt(Point(5, 5)), goblinAt(Point(6, 6)),
+                          goblinAt(Point(40, 40))};
+  population.reset(64, 64, monsters);
+  auto dead = monsters[1];
+  kill(dead);
+  std::minstd_rand random(1);
+
+  // Act
+  population.collect(monsters);
+  auto pooled = population.pooled();
+  auto respawned = population.respawn(*map, {}, monsters, random);
+  auto again = population.respawn(*map, {}, monsters, random);
+
+  // Assert
+  EXPECT_EQ(pooled, 1u);
+  ASSERT_EQ(respawned.size(), 1u);
+  EXPECT_EQ(respawned[0], dead);
+  EXPECT_TRUE(dead->isAlive());
+  EXPECT_LT(dead->position.x, 32);
+  EXPECT_LT(dead->position.y, 32);
+  EXPECT_EQ(monsters.size(), 3u);
+  EXPECT_EQ(population.pooled(), 0u);
+  EXPECT_TRUE(again.empty());
+}
+
+TEST(PopulationManagerTest, RespawnsOutOfSightOfThePlayers) {
+  // Arrange
+  auto map = openMap(32, 32);
+  PopulationManager population(32, 1, 1, 23);
+  MonsterList monsters = {goblinAt(Point(3, 3))};
+  population.reset(32, 32, monsters);
+  kill(monsters[0]);
+  population.collect(monsters);
+  PlayerList players = {std::make_shared<Player>()};
+  std::minstd_rand random(2);
+
+  // Act
+  // No cell is more than 23 cells away from the centre
+  players[0]->position = Point(16, 16);
+  size_t seen = 0;
+  for (int tick = 0; tick < 50; ++tick) {
+    seen += population.respawn(*map, players, monsters, random).size();
+  }
+  players[0]->position = Point(31, 31);
+  MonsterList respawned;
+  for (int tick = 0; tick < 50 && respawned.empty(); ++tick) {
+    respawned = population.respawn(*map, players, monsters, random);
+  }
+
+  // Assert
+  EXPECT_EQ(seen, 0u);
+  ASSERT_EQ(respawned.size(), 1u);
+  EXPECT_GT(respawned[0]->position.distance(players[0]->position), 23);
+}
+
+TEST(PopulationManagerTest, KeepsToTheBudgetAndPeriod) {
+  // Arrange
+  auto map = openMap(64, 64);
+  PopulationManager population(64, 3, 5, 0);
+  MonsterList monsters;
+  for (int i = 0; i < 10; ++i) {
+    monsters.push_back(goblinAt(Point(i, 0)));
+  }
+  population.reset(64, 64, monsters);
+  for (const auto &monster : monsters) {
+    kill(monster);
+  }
+  population.collect(monsters);
+  std::minstd_rand random(3);
+
+  // Act
+  std::vector<size_t> perTick;
+  for (int tick = 0; tick < 10; ++tick) {
+    perTick.push_back(
+        population.respawn(*map, {}, monsters, random).size());
+  }
+
+  // Assert
+  EXPECT_EQ(perTick, std::vector<size_t>({0, 0, 0, 0, 3, 0, 0, 0, 0, 3}));
+  EXPECT_EQ(monsters.size(), 6u);
+  EXPECT_EQ(population.pooled(), 4u);
+}
+
+TEST(PopulationManagerTest, RefillsRegionsOfAdoptedMonsters) {
+  // Arrange
+  auto map = openMap(64, 64);
+  PopulationManager population(32, 10, 1, 0);
+  MonsterList monsters;
+  population.reset(64, 64, monsters);
+  auto late = goblinAt(Point(40, 40)); // placed after the floor was entered
+  monsters.push_back(late);
+  population.adopt(*late);
+  kill(late);
+  population.collect(monsters);
+  std::minstd_rand random(4);
+
+  // Act
+  auto respawned = population.respawn(*map, {}, monsters, random);
+
+  // Assert
+  ASSERT_EQ(respawned.size(), 1u);
+  EXPECT_GE(respawned[0]->position.x, 32);
+  EXPECT_GE(respawned[0]->position.y, 32);
+}
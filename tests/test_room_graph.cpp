@@ -0,0 +1,131 @@
+#include "algorithms/bsp_rooms_generator.h"
+#include "algorithms/room_graph.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <queue>
+#include <set>
+
+namespace {
+// Three rooms in a row, each joined to the next by a short corridor
+//   0123456789012345
+// 0 ################
+// 1 #...##...##...##
+// 2 #....-...-....##
+// 3 #...##...##...##
+// 4 ################
+std::vector<std::string> rowOfRooms() {
+  return {"################", "#   ##   ##   ##", "#             ##",
+          "#   ##   ##   ##", "################"};
+}
+
+RoomGraph makeGraph(const std::vector<std::string> &maze,
+                    std::vector<Room> rooms) {
+  return RoomGraph(
+      maze[0].size(), maze.size(),
+      [&maze](const Point &point) { return maze[point.y][point.x] == '#'; },
+      std::move(rooms));
+}
+
+size_t reachableFromStart(std::vector<std::string> maze, const Point &start) {
+  std::queue<Point> frontier;
+  frontier.push(start);
+  maze[start.y][start.x] = '.';
+  size_t reached = 0;
+  while (!frontier.empty()) {
+    auto cell = frontier.front();
+    frontier.pop();
+    ++reached;
+    for (const auto &step : {Point(1, 0), Point(-1, 0), Point(0, 1),
+                             Point(0, -1)}) {
+      auto next = cell + step;
+      if (maze[next.y][next.x] == ' ') {
+        maze[next.y][next.x] = '.';
+        frontier.push(next);
+      }
+    }
+  }
+  return reached;
+}
+} // namespace
+
+TEST(RoomGraphTest, LinksRoomsThroughTheirCorridors) {
+  // Arrange
+  std::vector<Room> rooms = {{1, 1, 3, 3}, {6, 1, 3, 3}, {11, 1, 3, 3}};
+
+  // Act
+  auto graph = makeGraph(rowOfRooms(), rooms);
+
+  // Assert
+  ASSERT_EQ(graph.getLinks(0).size(), 1u);
+  ASSERT_EQ(graph.getLinks(1).size(), 2u);
+  ASSERT_EQ(graph.getLinks(2).size(), 1u);
+  EXPECT_EQ(graph.getLinks(0)[0].to, 1);
+  EXPECT_EQ(graph.getLinks(0)[0].exit, Point(4, 2));
+  EXPECT_EQ(graph.getLinks(0)[0].entry, Point(5, 2));
+  EXPECT_EQ(graph.getLinks(0)[0].length, 1);
+  EXPECT_EQ(graph.getDoors().size(), 4u);
+  EXPECT_EQ(graph.roomAt(Point(7, 3)), 1);
+  EXPECT_EQ(graph.roomAt(Point(4, 2)), -1);
+}
+
+TEST(RoomGraphTest, RoutesThroughTheRoomsOnTheWay) {
+  // Arrange
+  auto graph = makeGraph(rowOfRooms(),
+                         {{1, 1, 3, 3}, {6, 1, 3, 3}, {11, 1, 3, 3}});
+
+  // Act
+  auto route = graph.route(Point(1, 1), Point(13, 3));
+  auto back = graph.route(Point(13, 3), Point(1, 1));
+
+  // Assert
+  std::vector<Point> expected = {Point(4, 2), Point(5, 2), Point(9, 2),
+                                 Point(10, 2)};
+  EXPECT_EQ(route, expected);
+  EXPECT_EQ(back, std::vector<Point>(expected.rbegin(), expected.rend()));
+  EXPECT_TRUE(graph.route(Point(1, 1), Point(3, 3)).empty());
+  EXPECT_TRUE(graph.route(Point(4, 2), Point(13, 3)).empty());
+}
+
+TEST(RoomGraphTest, BspLevelsConnectEveryRoom) {
+  // Arrange
+  BspRoomsGenerator generator(100, 60, 17);
+  const auto &maze = generator.getMaze();
+  auto [startX, startY] = generator.getStart();
+
+  // Act
+  auto graph = makeGraph(maze, generator.getRooms());
+
+  // Assert
+  size_t floors = 0;
+  for (const auto &row : maze) {
+    floors += std::count(row.begin(), row.end(), ' ');
+  }
+  EXPECT_GT(generator.getRooms().size(), 10u);
+  EXPECT_EQ(reachableFromStart(maze, Point(startX, startY)), floors);
+  EXPECT_EQ(maze.front(), std::string(100, '#'));
+  EXPECT_EQ(maze.back(), std::string(100, '#'));
+  for (size_t room = 1; room < generator.getRooms().size(); ++room) {
+    auto route = graph.route(generator.getRooms().front().centre(),
+                             generator.getRooms()[room].centre());
+    ASSERT_FALSE(route.empty());
+    std::set<int> doorRooms;
+    for (const auto &door : graph.getDoors()) {
+      if (door.point == route.back()) {
+        doorRooms.insert(door.room);
+      }
+    }
+    EXPECT_EQ(doorRooms.count(static_cast<int>(room)), 1u);
+  }
+}
+
+TEST(RoomGraphTest, SameSeedGivesTheSameRooms) {
+  // Arrange
+  BspRoomsGenerator first(80, 50, 4);
+  BspRoomsGenerator second(80, 50, 4);
+  BspRoomsGenerator other(80, 50, 5);
+
+  // Act & Assert
+  EXPECT_EQ(first.getMaze(), second.getMaze());
+  EXPECT_NE(first.getMaze(), other.getMaze());
+  EXPECT_EQ(first.getStart(), second.getStart());
+}
@@ -0,0 +1,181 @@
+#include "model/sharded_simulation.h"
+#include "support/walker_world.h"
+#include "utils/worker_pool.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+struct World : WalkerWorld {
+  std::vector<CellChange> changes;
+  MapJournal::SubscriberId subscriber;
+
+  World() : WalkerWorld(96, 40) {}
+};
+
+std::unique_ptr<World> makeWorld() {
+  auto world = std::make_unique<World>();
+  for (int y = 0; y < 40; y += 7) {
+    for (int x = 3; x < 96; x += 5) {
+      world->map->grid.set(x, y, CellType::WALL);
+    }
+  }
+  world->map->hash.reset(world->map->computeHash());
+  for (uint32_t id = 0; id < 120; ++id) {
+    world->addWalker(Point((id * 37) % 96, 1 + (id * 11) % 38), id);
+  }
+  world->subscriber = world->map->journal.subscribe();
+  world->map->journal.drain(world->subscriber, [](const CellChange &) {});
+  return world;
+}
+
+void runTicks(World &world, unsigned int threads, int ticks) {
+  ShardedSimulation simulation(32, threads);
+
+  auto tryMove = [&world](const std::shared_ptr<Monster> &monster,
+                          const Point &target) {
+    world.tryMove(monster, target);
+  };
+
+  for (int tick = 0; tick < ticks; ++tick) {
+    simulation.tick(
+        *world.map, world.monsters,
+        [&](size_t index,
+            const ShardedSimulation::Strip &strip) -> std::optional<Point> {
+          const auto &monster = world.monsters[index];
+          auto target = monster->position + monster->getVelocity();
+          if (!strip.contains(target)) {
+            return target;
+          }
+          tryMove(monster, target);
+          return std::nullopt;
+        },
+        tryMove);
+    world.map->journal.drain(world.subscriber, [&](const CellChange &change) {
+      world.changes.push_back(change);
+    });
+  }
+}
+} // namespace
+
+TEST(ShardedSimulationTest, ResultsDoNotDependOnThreadCount) {
+  // Arrange
+  auto single = makeWorld();
+  auto parallel = makeWorld();
+
+  // Act
+  runTicks(*single, 1, 50);
+  runTicks(*parallel, 4, 50);
+
+  // Assert
+  ASSERT_EQ(single->monsters.size(), parallel->monsters.size());
+  for (size_t i = 0; i < single->monsters.size(); ++i) {
+    EXPECT_EQ(single->monsters[i]->position, parallel->monsters[i]->position);
+  }
+  ASSERT_EQ(single->changes.size(), parallel->changes.size());
+  for (size_t i = 0; i < single->changes.size(); ++i) {
+    EXPECT_EQ(single->changes[i].point, parallel->changes[i].point);
+  }
+  EXPECT_GT(single->changes.size(), 0u);
+  EXPECT_EQ(single->map->hash.get(), parallel->map->hash.get());
+  EXPECT_EQ(parallel->map->hash.get(), parallel->map->computeHash());
+}
+
+TEST(ShardedSimulationTest, MovesAcrossStripsGoThroughBorderPhase) {
+  // Arrange
+  auto map = openMap(64, 4);
+  MonsterList monsters = {std::make_shared<Walker>(0),
+                          std::make_shared<Walker>(1)};
+  monsters[0]->position = Point(31, 1); // steps into the second strip
+  monsters[1]->position = Point(40, 1); // stays in the second strip
+  ShardedSimulation simulation(32, 2);
+  std::vector<Point> borderTargets;
+  std::atomic<int> localMoves{0};
+
+  // Act
+  simulation.tick(
+      *map, monsters,
+      [&](size_t index,
+          const ShardedSimulation::Strip &strip) -> std::optional<Point> {
+        auto target = monsters[index]->position + Point(1, 0);
+        if (!strip.contains(target)) {
+          return target;
+        }
+        ++localMoves;
+        return std::nullopt;
+      },
+      [&](const std::shared_ptr<Monster> &, const Point &target) {
+        borderTargets.push_back(target);
+      });
+
+  // Assert
+  EXPECT_EQ(localMoves, 1);
+  EXPECT_EQ(borderTargets, std::vector<Point>{Point(32, 1)});
+}
+
+TEST(ShardedSimulationTest, StepsLivingMonstersByListIndex) {
+  // Arrange
+  auto map = openMap(64, 4);
+  MonsterList monsters = {std::make_shared<Walker>(0),
+                          std::make_shared<Walker>(1),
+                          std::make_shared<Walker>(2)};
+  monsters[0]->position = Point(40, 1);
+  monsters[1]->position = Point(41, 1);
+  monsters[2]->position = Point(1, 1);
+  monsters[1]->takeDamage(100);
+  ShardedSimulation simulation(32, 1);
+  std::vector<size_t> stepped;
+
+  // Act
+  simulation.tick(
+      *map, monsters,
+      [&](size_t index,
+          const ShardedSimulation::Strip &) -> std::optional<Point> {
+        stepped.push_back(index);
+        return std::nullopt;
+      },
+      [](const std::shared_ptr<Monster> &, const Point &) {});
+
+  // Assert
+  EXPECT_EQ(stepped, (std::vector<size_t>{2, 0}));
+}
+
+TEST(ShardedSimulationTest, StripWidthIsRoundedToIndexBuckets) {
+  // Arrange & Act
+  ShardedSimulation simulation(20, 1);
+
+  // Assert
+  EXPECT_EQ(simulation.getStripWidth(), 32u);
+}
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce) {
+  // Arrange
+  WorkerPool pool(4);
+  std::vector<std::atomic<int>> runs(1000);
+
+  // Act
+  for (int round = 0; round < 3; ++round) {
+    pool.parallelFor(runs.size(), [&runs](size_t index) { ++runs[index]; });
+  }
+
+  // Assert
+  for (const auto &count : runs) {
+    EXPECT_EQ(count.load(), 3);
+  }
+}
+
+TEST(WorkerPoolTest, RethrowsTaskExceptions) {
+  // Arrange
+  WorkerPool pool(3);
+
+  // Act & Assert
+  EXPECT_THROW(pool.parallelFor(10,
+                                [](size_t index) {
+                                  if (index == 7) {
+                                    throw std::runtime_error("task failed");
+                                  }
+                                }),
+               std::runtime_error);
+}
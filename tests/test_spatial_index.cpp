@@ -0,0 +1,146 @@
+#include "model/spatial_index.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+class Marker : public Entity {
+public:
+  explicit Marker(const Point &position) : Entity(position, CellType::ORC) {}
+  void move(const Point &destination) override { position = destination; }
+  std::string toString() const override { return "Marker"; }
+};
+
+std::vector<Point> positionsOf(const std::vector<Entity *> &entities) {
+  std::vector<Point> positions;
+  for (const auto *entity : entities) {
+    positions.push_back(entity->position);
+  }
+  std::sort(positions.begin(), positions.end(), [](Point a, Point b) {
+    return a.y != b.y ? a.y < b.y : a.x < b.x;
+  });
+  return positions;
+}
+} // namespace
+
+TEST(SpatialIndexTest, RectQuerySpansBuckets) {
+  // Arrange
+  SpatialIndex index(100, 100);
+  Marker inside1(Point(15, 15)), inside2(Point(16, 40)), outside(Point(41, 3));
+  index.insert(&inside1);
+  index.insert(&inside2);
+  index.insert(&outside);
+
+  // Act
+  auto found = positionsOf(index.queryRect(Point(40, 10), Point(10, 40)));
+
+  // Assert
+  std::vector<Point> expected = {Point(15, 15), Point(16, 40)};
+  EXPECT_EQ(found, expected);
+}
+
+TEST(SpatialIndexTest, RadiusQueryUsesEuclideanDistance) {
+  // Arrange
+  SpatialIndex index(64, 64);
+  Marker onCircle(Point(23, 20)), diagonal(Point(22, 22)),
+      corner(Point(23, 23));
+  index.insert(&onCircle);
+  index.insert(&diagonal);
+  index.insert(&corner);
+
+  // Act
+  auto found = positionsOf(index.queryRadius(Point(20, 20), 3));
+
+  // Assert
+  std::vector<Point> expected = {Point(23, 20), Point(22, 22)};
+  EXPECT_EQ(found, expected);
+}
+
+TEST(SpatialIndexTest, MoveAndRemoveKeepQueriesConsistent) {
+  // Arrange
+  SpatialIndex index(64, 64);
+  Marker walker(Point(1, 1)), other(Point(2, 2));
+  index.insert(&walker);
+  index.insert(&other);
+
+  // Act
+  index.move(&walker, Point(1, 1), Point(50, 50));
+  walker.move(Point(50, 50));
+  index.remove(&other, other.position);
+
+  // Assert
+  EXPECT_EQ(index.size(), 1u);
+  EXPECT_TRUE(index.queryRect(Point(0, 0), Point(15, 15)).empty());
+  EXPECT_EQ(positionsOf(index.queryRadius(Point(49, 49), 2)),
+            std::vector<Point>{Point(50, 50)});
+}
+
+TEST(SpatialIndexTest, NearestMatchesBruteForce) {
+  // Arrange
+  SpatialIndex index(200, 120);
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> randomX(0, 199), randomY(0, 119);
+  std::vector<std::unique_ptr<Marker>> markers;
+  for (int i = 0; i < 300; ++i) {
+    markers.push_back(
+        std::make_unique<Marker>(Point(randomX(rng), randomY(rng))));
+    index.insert(markers.back().get());
+  }
+
+  for (const auto &center : {Point(0, 0), Point(100, 60), Point(199, 5)}) {
+    // Act
+    auto found = index.nearest(center, 10);
+
+    // Assert
+    std::vector<double> expected;
+    for (const auto &marker : markers) {
+      expected.push_back(marker->position.distance(center));
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(found.size(), 10u);
+    for (size_t i = 0; i < found.size(); ++i) {
+      EXPECT_DOUBLE_EQ(found[i]->position.distance(center), expected[i]);
+    }
+  }
+}
+
+TEST(SpatialIndexTest, NearestSkipsRejectedEntities) {
+  // Arrange
+  SpatialIndex index(64, 64);
+  Marker self(Point(10, 10)), near(Point(12, 10)), far(Point(60, 60));
+  index.insert(&self);
+  index.insert(&near);
+  index.insert(&far);
+
+  // Act
+  auto found = index.nearest(self.position, 5, [&self](const Entity &entity) {
+    return &entity != &self;
+  });
+
+  // Assert
+  ASSERT_EQ(found.size(), 2u);
+  EXPECT_EQ(found[0], &near);
+  EXPECT_EQ(found[1], &far);
+}
+
+TEST(SpatialIndexTest, NearestBreaksTiesInScanOrder) {
+  // Arrange
+  SpatialIndex index(64, 64);
+  std::vector<Marker> markers = {Marker(Point(9, 10)), Marker(Point(10, 9)),
+                                 Marker(Point(11, 10)), Marker(Point(10, 11))};
+  // Inserted against their address order, which must not matter
+  for (auto marker = markers.rbegin(); marker != markers.rend(); ++marker) {
+    index.insert(&*marker);
+  }
+
+  // Act
+  auto found = index.nearest(Point(10, 10), 3);
+
+  // Assert
+  ASSERT_EQ(found.size(), 3u);
+  EXPECT_EQ(found[0], &markers[3]);
+  EXPECT_EQ(found[1], &markers[2]);
+  EXPECT_EQ(found[2], &markers[1]);
+}
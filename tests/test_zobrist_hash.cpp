@@ -0,0 +1,74 @@
+#include "model/map.h"
+#include "utils/zobrist_hash.h"
+#include "gtest/gtest.h"
+
+namespace {
+Map makeMap(GridLayout layout, GridStorage storage) {
+  Map map(40, 30, layout, storage);
+  map.grid = Grid(40, 30, layout, storage);
+  for (int x = 0; x < 40; ++x) {
+    map.grid.set(x, 0, CellType::WALL);
+    map.grid.set(x, 29, CellType::WALL);
+  }
+  map.hash.reset(map.computeHash());
+  return map;
+}
+} // namespace
+
+TEST(ZobristHashTest, FollowsCellChanges) {
+  // Arrange
+  auto map = makeMap(GridLayout::ROW_MAJOR, GridStorage::BYTE);
+  auto initial = map.hash.get();
+
+  // Act
+  map.setCellType(Point(5, 5), CellType::GOBLIN);
+  map.setCellType(Point(5, 5), CellType::EMPTY);
+  map.setCellType(Point(6, 5), CellType::GOBLIN);
+  auto moved = map.hash.get();
+  map.setCellType(Point(6, 5), CellType::EMPTY);
+
+  // Assert
+  EXPECT_NE(moved, initial);
+  EXPECT_EQ(map.hash.get(), initial);
+  EXPECT_EQ(map.computeHash(), initial);
+}
+
+TEST(ZobristHashTest, DoesNotDependOnOrderOfChanges) {
+  // Arrange
+  auto first = makeMap(GridLayout::ROW_MAJOR, GridStorage::BYTE);
+  auto second = makeMap(GridLayout::ROW_MAJOR, GridStorage::BYTE);
+
+  // Act
+  first.setCellType(Point(3, 4), CellType::ORC);
+  first.setCellType(Point(8, 2), CellType::TREASURE);
+  second.setCellType(Point(8, 2), CellType::TREASURE);
+  second.setCellType(Point(3, 4), CellType::ORC);
+
+  // Assert
+  EXPECT_EQ(first.hash.get(), second.hash.get());
+  EXPECT_EQ(first.hash.get(), first.computeHash());
+}
+
+TEST(ZobristHashTest, DoesNotDependOnGridLayout) {
+  // Arrange
+  auto rows = makeMap(GridLayout::ROW_MAJOR, GridStorage::BYTE);
+  auto morton = makeMap(GridLayout::MORTON, GridStorage::PACKED);
+
+  // Act
+  rows.setCellType(Point(12, 20), CellType::DRAGON);
+  morton.setCellType(Point(12, 20), CellType::DRAGON);
+
+  // Assert
+  EXPECT_EQ(rows.hash.get(), morton.hash.get());
+}
+
+TEST(ZobristHashTest, EmptyCellsAddNothing) {
+  // Arrange
+  Map map(8, 8);
+  map.grid = Grid(8, 8);
+
+  // Act & Assert
+  EXPECT_EQ(map.computeHash(), 0u);
+  EXPECT_NE(ZobristHash::cellKey(Point(1, 2), CellType::WALL),
+            ZobristHash::cellKey(Point(2, 1), CellType::WALL));
+}
@@ -0,0 +1,23 @@
+#include "utils/event_logger.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <events.bin>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in.is_open()) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  if (!EventLogger::decode(in, std::cout)) {
+    std::cerr << argv[1] << " is not a valid event log" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}